@@ -0,0 +1,193 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "ldpc_backend.h"
+#include "ldpc_decoder/simd.hh"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace gr::dvbs2rx;
+
+/*
+ * This file is compiled for the native instruction set, so the benchmarks below use
+ * the widest int8 SIMD type supported by the host machine.
+ */
+#if defined(__AVX512BW__)
+typedef SIMD<int8_t, 64> simd_type;
+#elif defined(__AVX2__)
+typedef SIMD<int8_t, 32> simd_type;
+#else
+typedef SIMD<int8_t, 16> simd_type;
+#endif
+
+struct transpose_fixture_t {
+    const int len;
+    std::vector<int8_t> code;
+    simd_type* data;
+    transpose_fixture_t(int len) : len(len), code(simd_type::SIZE * len)
+    {
+        for (auto& x : code)
+            x = rand();
+        data = reinterpret_cast<simd_type*>(
+            aligned_alloc(sizeof(simd_type), sizeof(simd_type) * len));
+    }
+    ~transpose_fixture_t() { free(data); }
+};
+
+// Element-by-element loops originally used by the LDPC decoder
+static void BM_ldpc_serial_to_parallel_scalar(benchmark::State& state)
+{
+    transpose_fixture_t f(state.range(0));
+    for (auto _ : state) {
+        for (int n = 0; n < simd_type::SIZE; n++)
+            for (int j = 0; j < f.len; j++)
+                reinterpret_cast<int8_t*>(f.data + j)[n] = f.code[(n * f.len) + j];
+        benchmark::DoNotOptimize(f.data);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * f.code.size());
+}
+BENCHMARK(BM_ldpc_serial_to_parallel_scalar)->Arg(16200)->Arg(64800);
+
+static void BM_ldpc_parallel_to_serial_scalar(benchmark::State& state)
+{
+    transpose_fixture_t f(state.range(0));
+    vload_transposed(f.data, f.code.data(), f.len);
+    for (auto _ : state) {
+        for (int n = 0; n < simd_type::SIZE; n++)
+            for (int j = 0; j < f.len; j++)
+                f.code[(n * f.len) + j] = reinterpret_cast<int8_t*>(f.data + j)[n];
+        benchmark::DoNotOptimize(f.code.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * f.code.size());
+}
+BENCHMARK(BM_ldpc_parallel_to_serial_scalar)->Arg(16200)->Arg(64800);
+
+// SIMD block transposes
+static void BM_ldpc_serial_to_parallel(benchmark::State& state)
+{
+    transpose_fixture_t f(state.range(0));
+    for (auto _ : state) {
+        vload_transposed(f.data, f.code.data(), f.len);
+        benchmark::DoNotOptimize(f.data);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * f.code.size());
+}
+BENCHMARK(BM_ldpc_serial_to_parallel)->Arg(16200)->Arg(64800);
+
+static void BM_ldpc_parallel_to_serial(benchmark::State& state)
+{
+    transpose_fixture_t f(state.range(0));
+    vload_transposed(f.data, f.code.data(), f.len);
+    for (auto _ : state) {
+        vstore_transposed(f.code.data(), f.data, f.len);
+        benchmark::DoNotOptimize(f.code.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * f.code.size());
+}
+BENCHMARK(BM_ldpc_parallel_to_serial)->Arg(16200)->Arg(64800);
+
+/*
+ * Hard-decision bit packing of a decoded codeword (short and normal FECFRAMEs) into
+ * MSB-first bytes, as done on the output of the LDPC decoder block.
+ */
+struct pack_fixture_t {
+    const int len;
+    std::vector<int8_t> soft;
+    std::vector<uint8_t> bytes;
+    pack_fixture_t(int len) : len(len), soft(len), bytes(len / 8)
+    {
+        for (auto& x : soft)
+            x = rand();
+    }
+};
+
+// Bit-by-bit loop originally used by the LDPC decoder block
+static void BM_ldpc_pack_bits_scalar(benchmark::State& state)
+{
+    pack_fixture_t f(state.range(0));
+    for (auto _ : state) {
+        uint8_t* out = f.bytes.data();
+        for (int j = 0; j < f.len / 8; j++) {
+            *out = 0;
+            for (int k = 0; k < 8; k++) {
+                if (f.soft[(j * 8) + k] < 0) {
+                    *out |= 1 << (7 - k);
+                }
+            }
+            out++;
+        }
+        benchmark::DoNotOptimize(f.bytes.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * f.len);
+}
+BENCHMARK(BM_ldpc_pack_bits_scalar)->Arg(16200)->Arg(64800);
+
+static void BM_ldpc_pack_bits(benchmark::State& state)
+{
+    pack_fixture_t f(state.range(0));
+    for (auto _ : state) {
+        ldpc_pack_hard_decisions(f.bytes.data(), f.soft.data(), f.len);
+        benchmark::DoNotOptimize(f.bytes.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * f.len);
+}
+BENCHMARK(BM_ldpc_pack_bits)->Arg(16200)->Arg(64800);
+
+/*
+ * Decoding throughput of the generic and table-specialized LDPC decoders on the SIMD
+ * backend selected at runtime. The input LLRs are random, so that no codeword
+ * converges and every batch runs for the full number of iterations.
+ */
+static void BM_ldpc_decode(benchmark::State& state)
+{
+    const auto framesize = static_cast<dvb_framesize_t>(state.range(0));
+    const auto rate = static_cast<dvb_code_rate_t>(state.range(1));
+    const bool specialized = state.range(2);
+    const int trials = 10;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, framesize, rate);
+    auto decoder = specialized ? make_ldpc_decoder(STANDARD_DVBS2, framesize, rate)
+                               : make_ldpc_decoder(ldpc.get());
+    const int n_frames = decoder->simd_size();
+    std::vector<int8_t> llrs(n_frames * ldpc->code_len());
+    std::vector<int8_t> batch(llrs.size());
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<> dis(-8, 8);
+    for (auto& llr : llrs)
+        llr = dis(gen);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        batch = llrs;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(decoder->decode(batch.data(), trials));
+    }
+    state.SetItemsProcessed(state.iterations() * n_frames);
+    state.SetLabel(std::string(decoder->impl()) + (specialized ? "/table" : "/generic"));
+}
+
+static void ldpc_modcods(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "framesize", "rate", "table" });
+    for (int specialized : { 0, 1 }) {
+        for (int rate : { C1_4, C1_3, C2_5, C1_2, C3_5, C2_3, C3_4, C4_5, C5_6, C8_9 }) {
+            b->Args({ FECFRAME_NORMAL, rate, specialized });
+            b->Args({ FECFRAME_SHORT, rate, specialized });
+        }
+        b->Args({ FECFRAME_NORMAL, C9_10, specialized });
+    }
+}
+BENCHMARK(BM_ldpc_decode)->Apply(ldpc_modcods)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,305 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * LDPC decoding throughput across the supported codes and the SIMD backends available
+ * on the host machine, each with its 8-bit and 16-bit ("<backend>_int16") decoders.
+ * Each benchmark decodes batches of one codeword per SIMD lane and reports the
+ * throughput in LDPC information bits (Mbit) and in frames per second. There are two
+ * families of benchmarks:
+ *
+ * - BM_ldpc_decode: random input LLRs, which never converge to a codeword, so that
+ *   every batch runs for the given (fixed) number of iterations.
+ * - BM_ldpc_decode_awgn: random codewords with BPSK modulation over an AWGN channel
+ *   at a given Eb/N0, decoded with up to 25 iterations and early termination. These
+ *   also report the average number of iterations per batch (iters) and the frame
+ *   error rate (fer).
+ *
+ * The results are printed in JSON format by default, so that they can be stored and
+ * compared across builds to track regressions (see README.md).
+ */
+
+#include "ldpc_backend.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace gr::dvbs2rx;
+using benchmark::Counter;
+
+namespace {
+
+const int n_batches = 4;              // distinct batches decoded in turns
+const int awgn_trials = 25;           // maximum iterations on the AWGN channel
+const int fixed_trials[] = { 10, 25 }; // iterations on random LLRs
+const float ebn0_db[] = { 1.0, 2.5, 4.0, 6.0 };
+
+const std::pair<dvb_framesize_t, const char*> framesizes[] = {
+    { FECFRAME_NORMAL, "normal" },
+    { FECFRAME_SHORT, "short" },
+    { FECFRAME_MEDIUM, "medium" },
+};
+
+const std::pair<dvb_code_rate_t, const char*> rates[] = {
+    { C1_4, "C1_4" },
+    { C1_3, "C1_3" },
+    { C2_5, "C2_5" },
+    { C1_2, "C1_2" },
+    { C3_5, "C3_5" },
+    { C2_3, "C2_3" },
+    { C3_4, "C3_4" },
+    { C4_5, "C4_5" },
+    { C5_6, "C5_6" },
+    { C7_8, "C7_8" },
+    { C8_9, "C8_9" },
+    { C9_10, "C9_10" },
+    { C13_45, "C13_45" },
+    { C9_20, "C9_20" },
+    { C90_180, "C90_180" },
+    { C96_180, "C96_180" },
+    { C11_20, "C11_20" },
+    { C100_180, "C100_180" },
+    { C104_180, "C104_180" },
+    { C26_45, "C26_45" },
+    { C18_30, "C18_30" },
+    { C28_45, "C28_45" },
+    { C23_36, "C23_36" },
+    { C116_180, "C116_180" },
+    { C20_30, "C20_30" },
+    { C124_180, "C124_180" },
+    { C25_36, "C25_36" },
+    { C128_180, "C128_180" },
+    { C13_18, "C13_18" },
+    { C132_180, "C132_180" },
+    { C22_30, "C22_30" },
+    { C135_180, "C135_180" },
+    { C140_180, "C140_180" },
+    { C7_9, "C7_9" },
+    { C154_180, "C154_180" },
+    { C11_45, "C11_45" },
+    { C4_15, "C4_15" },
+    { C14_45, "C14_45" },
+    { C7_15, "C7_15" },
+    { C8_15, "C8_15" },
+    { C32_45, "C32_45" },
+    { C2_9_VLSNR, "C2_9_VLSNR" },
+    { C1_5_MEDIUM, "C1_5_MEDIUM" },
+    { C11_45_MEDIUM, "C11_45_MEDIUM" },
+    { C1_3_MEDIUM, "C1_3_MEDIUM" },
+    { C1_5_VLSNR_SF2, "C1_5_VLSNR_SF2" },
+    { C11_45_VLSNR_SF2, "C11_45_VLSNR_SF2" },
+    { C1_5_VLSNR, "C1_5_VLSNR" },
+    { C4_15_VLSNR, "C4_15_VLSNR" },
+    { C1_3_VLSNR, "C1_3_VLSNR" },
+};
+
+/*
+ * Input LLRs of a code, shared by the benchmarks of all backends. The benchmarks are
+ * registered with the backends in the innermost loop, so only the last generated
+ * input is kept, with frames enough for the widest backend.
+ */
+struct ldpc_input_t {
+    int framesize;
+    int rate;
+    float ebn0_db; // NaN for random LLRs
+    int n_frames;
+    std::vector<int8_t> llrs;
+    std::vector<uint8_t> packed; // transmitted codewords, N / 8 bytes per frame
+};
+
+// Systematic encoding based on the IRA structure of the DVB codes
+std::vector<uint8_t> ldpc_encode(LDPCInterface* ldpc, const std::vector<uint8_t>& msg)
+{
+    const int n = ldpc->code_len();
+    const int k = ldpc->data_len();
+    std::vector<uint8_t> codeword(msg.begin(), msg.end());
+    codeword.resize(n, 0);
+    uint8_t* parity = codeword.data() + k;
+    std::unique_ptr<LDPCInterface> it(ldpc->clone());
+    it->first_bit();
+    for (int j = 0; j < k; j++) {
+        const int* acc_pos = it->acc_pos();
+        for (int i = 0; i < it->bit_deg(); i++)
+            parity[acc_pos[i]] ^= msg[j];
+        it->next_bit();
+    }
+    for (int i = 1; i < (n - k); i++)
+        parity[i] ^= parity[i - 1];
+    return codeword;
+}
+
+const ldpc_input_t& get_input(dvb_framesize_t framesize,
+                              dvb_code_rate_t rate,
+                              float ebn0_db,
+                              int n_frames)
+{
+    static ldpc_input_t input = { -1, -1, 0, 0, {}, {} };
+    const bool same_ebn0 = (std::isnan(ebn0_db) && std::isnan(input.ebn0_db)) ||
+                           ebn0_db == input.ebn0_db;
+    if (input.framesize == framesize && input.rate == rate && same_ebn0 &&
+        input.n_frames >= n_frames)
+        return input;
+
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, framesize, rate);
+    const int n = ldpc->code_len();
+    const int k = ldpc->data_len();
+    input = { framesize, rate, ebn0_db, n_frames, {}, {} };
+    input.llrs.resize(n_frames * n);
+    input.packed.assign(n_frames * n / 8, 0);
+    std::mt19937 gen(0);
+    if (std::isnan(ebn0_db)) {
+        std::uniform_int_distribution<> dis(-8, 8);
+        for (auto& llr : input.llrs)
+            llr = dis(gen);
+        return input;
+    }
+
+    // BPSK (bit 0 to +1 and bit 1 to -1) with the LLR scaling of the demapper
+    std::uniform_int_distribution<> bit_dis(0, 1);
+    const float esn0_db = ebn0_db + 10 * std::log10((float)k / n);
+    const float n0 = std::pow(10.0f, -esn0_db / 10);
+    std::normal_distribution<float> noise_dis(0, std::sqrt(n0 / 2));
+    const float scale = 4.0f / n0;
+    for (int i = 0; i < n_frames; i++) {
+        std::vector<uint8_t> msg(k);
+        for (auto& bit : msg)
+            bit = bit_dis(gen);
+        const std::vector<uint8_t> codeword = ldpc_encode(ldpc.get(), msg);
+        for (int j = 0; j < n; j++) {
+            const float rx = (codeword[j] ? -1 : 1) + noise_dis(gen);
+            const float llr = std::round(scale * rx);
+            input.llrs[i * n + j] = std::max(-128.0f, std::min(127.0f, llr));
+            input.packed[(i * n + j) / 8] |= codeword[j] << (7 - j % 8);
+        }
+    }
+    return input;
+}
+
+void bm_ldpc_decode(benchmark::State& state,
+                    dvb_framesize_t framesize,
+                    dvb_code_rate_t rate,
+                    const std::string& backend,
+                    int trials,
+                    float ebn0_db)
+{
+    auto decoder = make_ldpc_decoder(STANDARD_DVBS2, framesize, rate, backend);
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, framesize, rate);
+    const int n = ldpc->code_len();
+    const int lanes = decoder->simd_size();
+    const ldpc_input_t& input = get_input(framesize, rate, ebn0_db, n_batches * lanes);
+    std::vector<const int8_t*> frames(n_batches * lanes);
+    for (size_t i = 0; i < frames.size(); i++)
+        frames[i] = input.llrs.data() + i * n;
+
+    int64_t batch = 0;
+    int64_t iterations = 0;
+    for (auto _ : state) {
+        const int result =
+            decoder->decode(frames.data() + (batch++ % n_batches) * lanes, trials);
+        iterations += result < 0 ? trials : trials - result;
+    }
+
+    const double n_frames = (double)state.iterations() * lanes;
+    const double n_bits = n_frames * ldpc->data_len();
+    state.counters["Mbit"] = Counter(n_bits * 1e-6, Counter::kIsRate);
+    state.counters["frames"] = Counter(n_frames, Counter::kIsRate);
+    state.counters["iters"] = Counter(iterations, Counter::kAvgIterations);
+    state.SetLabel(decoder->impl());
+    if (std::isnan(ebn0_db))
+        return;
+
+    // Frame error rate over the decoded batches, outside of the timed loop
+    std::vector<uint8_t> packed(lanes * n / 8);
+    int errors = 0;
+    for (int b = 0; b < n_batches; b++) {
+        decoder->decode(frames.data() + b * lanes, trials);
+        decoder->pack(packed.data(), n);
+        for (int i = 0; i < lanes; i++) {
+            const uint8_t* expected = input.packed.data() + (b * lanes + i) * n / 8;
+            errors += memcmp(packed.data() + i * n / 8, expected, n / 8) != 0;
+        }
+    }
+    state.counters["fer"] = (double)errors / (n_batches * lanes);
+}
+
+void register_benchmarks()
+{
+    std::vector<std::string> backends;
+    for (const auto& backend : get_ldpc_backends()) {
+        backends.push_back(backend);
+        backends.push_back(backend + "_int16");
+    }
+    for (const auto& framesize : framesizes) {
+        for (const auto& rate : rates) {
+            if (!make_ldpc_code(STANDARD_DVBS2, framesize.first, rate.first))
+                continue;
+            const std::string code = std::string(framesize.second) + "/" + rate.second;
+            for (int trials : fixed_trials) {
+                for (const auto& backend : backends) {
+                    const std::string name = "BM_ldpc_decode/" + backend + "/" + code +
+                                             "/iters:" + std::to_string(trials);
+                    benchmark::RegisterBenchmark(name.c_str(),
+                                                 bm_ldpc_decode,
+                                                 framesize.first,
+                                                 rate.first,
+                                                 backend,
+                                                 trials,
+                                                 NAN)
+                        ->Unit(benchmark::kMillisecond);
+                }
+            }
+            for (float ebn0 : ebn0_db) {
+                char ebn0_str[16];
+                snprintf(ebn0_str, sizeof(ebn0_str), "%.1f", ebn0);
+                for (const auto& backend : backends) {
+                    const std::string name = "BM_ldpc_decode_awgn/" + backend + "/" +
+                                             code + "/ebn0_db:" + ebn0_str;
+                    benchmark::RegisterBenchmark(name.c_str(),
+                                                 bm_ldpc_decode,
+                                                 framesize.first,
+                                                 rate.first,
+                                                 backend,
+                                                 awgn_trials,
+                                                 ebn0)
+                        ->Unit(benchmark::kMillisecond);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    register_benchmarks();
+
+    // Print JSON unless another format is given explicitly
+    std::vector<char*> args(argv, argv + argc);
+    char json_format[] = "--benchmark_format=json";
+    bool has_format = false;
+    for (int i = 1; i < argc; i++)
+        has_format |= strncmp(argv[i], "--benchmark_format", 18) == 0;
+    if (!has_format)
+        args.insert(args.begin() + 1, json_format);
+    int n_args = args.size();
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&n_args, args.data());
+    if (benchmark::ReportUnrecognizedArguments(n_args, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
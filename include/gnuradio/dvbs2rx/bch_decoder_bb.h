@@ -35,12 +35,30 @@ public:
      * constructor is in a private implementation
      * class. dvbs2rx::bch_decoder_bb::make is the public interface for
      * creating new instances.
+     *
+     * \param standard DVB standard.
+     * \param framesize FECFRAME size.
+     * \param rate Code rate.
+     * \param outputmode Output mode.
+     * \param debug_level Debug level for logs.
+     * \param converged_mode Handling of the frames tagged as converged by the LDPC
+     * decoder through the "ldpc_status" stream tag: full decoding
+     * (BCH_CONVERGED_DECODE), a syndrome check only, with a non-zero syndrome counted
+     * as a frame error and the message output uncorrected (BCH_CONVERGED_CHECK), or no
+     * check at all, with the frame counted as error-free (BCH_CONVERGED_SKIP). Untagged
+     * frames and frames that did not converge are always fully decoded.
+     * \param num_threads Number of decoding threads. With more than one thread, the
+     * codewords available on each call to the work function are split into chunks
+     * decoded concurrently, one per thread, while the output and the frame and error
+     * counts remain in frame order.
      */
     static sptr make(dvb_standard_t standard,
                      dvb_framesize_t framesize,
                      dvb_code_rate_t rate,
                      dvb_outputmode_t outputmode,
-                     int debug_level = 0);
+                     int debug_level = 0,
+                     dvb_bch_converged_t converged_mode = BCH_CONVERGED_DECODE,
+                     int num_threads = 1);
 
     /*!
      * \brief Get count of processed FECFRAMEs.
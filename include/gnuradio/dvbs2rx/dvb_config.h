@@ -120,6 +120,29 @@ enum dvb_infomode_t {
     INFO_ON,
 };
 
+enum dvb_llr_feedback_t {
+    LLR_FEEDBACK_OFF = 0,
+    LLR_FEEDBACK_SOFT,
+    LLR_FEEDBACK_HARD,
+};
+
+enum dvb_ldpc_schedule_t {
+    LDPC_SCHEDULE_LAYERED = 0,
+    LDPC_SCHEDULE_FLOODING,
+};
+
+enum dvb_ldpc_precision_t {
+    LDPC_PRECISION_INT8 = 0,
+    LDPC_PRECISION_INT16,
+    LDPC_PRECISION_AUTO,
+};
+
+enum dvb_bch_converged_t {
+    BCH_CONVERGED_DECODE = 0,
+    BCH_CONVERGED_CHECK,
+    BCH_CONVERGED_SKIP,
+};
+
 } // namespace dvbs2rx
 } // namespace gr
 
@@ -130,5 +153,9 @@ typedef gr::dvbs2rx::dvb_constellation_t dvb_constellation_t;
 typedef gr::dvbs2rx::dvb_guardinterval_t dvb_guardinterval_t;
 typedef gr::dvbs2rx::dvb_outputmode_t dvb_outputmode_t;
 typedef gr::dvbs2rx::dvb_infomode_t dvb_infomode_t;
+typedef gr::dvbs2rx::dvb_llr_feedback_t dvb_llr_feedback_t;
+typedef gr::dvbs2rx::dvb_ldpc_schedule_t dvb_ldpc_schedule_t;
+typedef gr::dvbs2rx::dvb_ldpc_precision_t dvb_ldpc_precision_t;
+typedef gr::dvbs2rx::dvb_bch_converged_t dvb_bch_converged_t;
 
 #endif /* INCLUDED_DVBS2RX_DVB_CONFIG_H */
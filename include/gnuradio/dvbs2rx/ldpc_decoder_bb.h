@@ -14,6 +14,8 @@
 #include <gnuradio/block.h>
 #include <gnuradio/dvbs2rx/api.h>
 #include <gnuradio/dvbs2rx/dvb_config.h>
+#include <cstdint>
+#include <vector>
 
 namespace gr {
 namespace dvbs2rx {
@@ -34,6 +36,81 @@ public:
      * To avoid accidental use of raw pointers, dvbs2rx::ldpc_decoder_bb's constructor is
      * in a private implementation class. dvbs2rx::ldpc_decoder_bb::make is the public
      * interface for creating new instances.
+     *
+     * Each output frame carries an "ldpc_status" stream tag at its first byte, whose
+     * value is a pair with the convergence status (true when all parity checks are
+     * satisfied) and the number of decoding iterations. The BCH decoder can use this
+     * tag to skip the decoding of converged frames.
+     *
+     * \param standard DVB standard.
+     * \param framesize FECFRAME size.
+     * \param rate LDPC code rate.
+     * \param constellation Constellation.
+     * \param outputmode Output the full codeword or just the message.
+     * \param infomode Show the corrected SNR.
+     * \param max_trials Maximum number of decoding iterations (0 for the default).
+     * \param debug_level Debug level for logs.
+     * \param num_threads Number of decoding threads. With more than one thread, the
+     * SIMD batches of frames are decoded concurrently by a pool of worker threads,
+     * each with its own decoder, and the output is reassembled in frame order. With a
+     * single thread, the decoding runs on the block's own thread.
+     * \param batch_frames Number of frames that triggers the decoding of a SIMD batch.
+     * When set to 0 (the default), the decoder waits for a full batch (e.g., 32 frames
+     * with AVX2) to maximize throughput. Lower values reduce the latency by decoding
+     * partially filled batches, with the remaining SIMD lanes left unused. Higher values
+     * enable rolling-lane decoding, where each SIMD lane is refilled with the next frame
+     * of the batch as soon as its current frame converges, so that a hard-to-decode
+     * frame does not hold back the other lanes.
+     * \param batch_timeout_ms Maximum time in milliseconds a frame can wait for the
+     * batch to fill up before the partial batch is decoded. When set to 0 (the
+     * default), batches are decoded only once batch_frames frames have arrived.
+     * \param acm_vcm Whether to decode in ACM/VCM mode, where the code of each frame
+     * is given by the "XFECFRAME" stream tag (MODCOD and short FECFRAME flag) placed
+     * by the PL Sync block at the start of the frame. In this mode, the frames of
+     * each MODCOD are grouped into their own SIMD batches and decoded by a pool of
+     * decoders created on the first occurrence of the MODCOD, while the output
+     * preserves the input frame order and carries the "XFECFRAME" tag at the start
+     * of each output frame. The framesize and rate parameters define the code
+     * expected initially, and untagged input is discarded. Only supported with the
+     * DVB-S2 standard.
+     * \param llr_feedback Format of the decoded LLRs sent through the "llr_pdu"
+     * message port, which the XFECFRAME demapper uses to refine its SNR estimate:
+     * disabled (LLR_FEEDBACK_OFF), the int8 soft LLRs (LLR_FEEDBACK_SOFT), or the
+     * hard decisions packed into bytes, MSB first (LLR_FEEDBACK_HARD). The latter
+     * reduces the PDU size by a factor of eight, and the PDU metadata indicates the
+     * format through its "packed" key. The metadata also lists the stream index of
+     * each frame in the PDU through its "frame_idx" key, given that, in ACM/VCM mode,
+     * the frames decoded together are not necessarily consecutive in the stream.
+     * \param llr_feedback_interval Interval, in decoded batches, between consecutive
+     * LLR PDUs. For instance, with an interval of 4, only the LLRs of every fourth
+     * batch are sent.
+     * \param adaptive_trials Whether to adapt the maximum number of decoding trials to
+     * the channel conditions. When enabled, max_trials becomes an upper bound, and the
+     * budget applied to each batch follows the recent iteration counts, the frame
+     * error rate, and the post-decoder SNR of each code. The budget is raised back to
+     * max_trials when frames fail to converge, and it drops to a small floor when most
+     * frames fail at an SNR well below the level at which they used to decode (e.g.,
+     * during a fade), so that undecodable frames do not consume max_trials iterations
+     * each. See get_trials_budget().
+     * \param schedule LDPC decoding schedule. With the layered schedule
+     * (LDPC_SCHEDULE_LAYERED), each decoder processes a batch of frames on its SIMD
+     * lanes, and num_threads sets the number of decoders running concurrently. With
+     * the flooding schedule (LDPC_SCHEDULE_FLOODING), the frames are decoded one at a
+     * time, each with its bit and check node updates split across num_threads
+     * threads. The flooding schedule needs no batch of frames to fill up, so it
+     * reduces the latency of each frame on a single high-rate carrier, at the cost of
+     * throughput and of more iterations per frame. See get_average_latency().
+     * \param precision Precision of the LDPC decoder's messages. The 8-bit precision
+     * (LDPC_PRECISION_INT8) decodes the most frames in parallel. The 16-bit precision
+     * (LDPC_PRECISION_INT16) decodes half as many frames in parallel, but it needs
+     * fewer iterations and a lower SNR to converge on low-rate codes, such as the
+     * DVB-S2X VL-SNR codes. With LDPC_PRECISION_AUTO, the precision is selected per
+     * code (i.e., per MODCOD in ACM/VCM mode), with 16 bits for the codes with rate
+     * up to 1/3 and 8 bits otherwise. Only applies to the layered schedule.
+     * \param check_period Interval in iterations between the convergence checks of the
+     * LDPC decoder. By default (1), the parity equations are checked on every
+     * iteration. Longer periods save the cost of the checks in between, at the expense
+     * of up to check_period - 1 extra iterations once a codeword converges.
      */
     static sptr make(dvb_standard_t standard,
                      dvb_framesize_t framesize,
@@ -42,13 +119,84 @@ public:
                      dvb_outputmode_t outputmode,
                      dvb_infomode_t infomode,
                      int max_trials,
-                     int debug_level = 0);
+                     int debug_level = 0,
+                     int num_threads = 1,
+                     int batch_frames = 0,
+                     float batch_timeout_ms = 0,
+                     bool acm_vcm = false,
+                     dvb_llr_feedback_t llr_feedback = LLR_FEEDBACK_SOFT,
+                     int llr_feedback_interval = 1,
+                     bool adaptive_trials = false,
+                     dvb_ldpc_schedule_t schedule = LDPC_SCHEDULE_LAYERED,
+                     dvb_ldpc_precision_t precision = LDPC_PRECISION_INT8,
+                     int check_period = 1);
 
     /*!
      * \brief Get the average number of LDPC decoding iterations per frame.
      * \return unsigned int Average decoding interations.
      */
     virtual unsigned int get_average_trials() = 0;
+
+    /*!
+     * \brief Get the current maximum number of LDPC decoding iterations per frame.
+     *
+     * With adaptive trials, returns the budget applied to the code of the most
+     * recently decoded batch. Otherwise, returns the fixed max_trials.
+     *
+     * \return int Maximum decoding iterations.
+     */
+    virtual int get_trials_budget() = 0;
+
+    /*!
+     * \brief Get the average latency of the decoded frames.
+     *
+     * The latency of each frame is measured from the work call in which its last LLR
+     * arrives until the work call in which its decoded output is produced, thus
+     * including the time waiting for its batch to fill up.
+     *
+     * \return float Average latency per frame in milliseconds.
+     */
+    virtual float get_average_latency() = 0;
+
+    /*!
+     * \brief Get the average number of LDPC decoding iterations per frame.
+     *
+     * Unlike get_average_trials(), which counts the iterations of each batch of
+     * frames decoded together on the SIMD lanes, this function counts the iterations
+     * until each frame converges on its own lane.
+     *
+     * \return float Average decoding iterations per frame.
+     */
+    virtual float get_average_iterations() = 0;
+
+    /*!
+     * \brief Get the histogram of LDPC decoding iterations per frame.
+     *
+     * Element i of the returned vector holds the number of frames decoded with i
+     * iterations, counting the iterations until each frame converges on its SIMD lane.
+     * The frames that do not converge are counted with the maximum number of
+     * iterations applied to them (see get_max_iteration_count()).
+     *
+     * \return std::vector<uint64_t> Frame counts indexed by number of iterations.
+     */
+    virtual std::vector<uint64_t> get_iteration_histogram() = 0;
+
+    /*!
+     * \brief Get the number of frames that reached the maximum number of iterations
+     * without converging to a valid codeword.
+     * \return uint64_t Frame count.
+     */
+    virtual uint64_t get_max_iteration_count() = 0;
+
+    /*!
+     * \brief Get the average time spent decoding each batch of frames.
+     *
+     * Measures the decoding itself on the thread that runs it, excluding the time
+     * the frames spend waiting for their batch to fill up or for a worker thread.
+     *
+     * \return float Average decoding time per batch in milliseconds.
+     */
+    virtual float get_average_decode_time() = 0;
 };
 
 } // namespace dvbs2rx
@@ -16,6 +16,9 @@
 namespace gr {
 namespace dvbs2rx {
 
+// Number of codewords whose syndrome remainders are computed at once by decode_batch()
+static constexpr size_t batch_chunk_size = 16;
+
 void assert_byte_aligned_n_k(uint32_t n, uint32_t k)
 {
     if (n % 8 != 0 || k % 8 != 0)
@@ -23,6 +26,14 @@ void assert_byte_aligned_n_k(uint32_t n, uint32_t k)
             "u8 array messages are only supported for n and k multiple of 8.");
 }
 
+inline bool is_zero_rem(const uint64_t* rem, int n_words)
+{
+    bool is_zero = true;
+    for (int w = 0; w < n_words; w++)
+        is_zero &= rem[w] == 0;
+    return is_zero;
+}
+
 /**
  * @brief Compute the generator polynomial g(x) for a BCH code.
  *
@@ -63,9 +74,18 @@ gf2_poly<P> compute_gen_poly(const galois_field<T>* const gf, uint8_t t)
 
 template <typename T, typename P>
 bch_codec<T, P>::bch_codec(const galois_field<T>* const gf, uint8_t t, uint32_t n)
+    : bch_codec(gf, t, n, compute_gen_poly<T, P>(gf, t))
+{
+}
+
+template <typename T, typename P>
+bch_codec<T, P>::bch_codec(const galois_field<T>* const gf,
+                           uint8_t t,
+                           uint32_t n,
+                           const gf2_poly<P>& g)
     : m_gf(gf),
       m_t(t),
-      m_g(std::move(compute_gen_poly<T, P>(gf, t))),
+      m_g(g),
       m_n(n == 0 ? ((static_cast<uint32_t>(1) << gf->get_m()) - 1) : n),
       m_s(((static_cast<uint32_t>(1) << gf->get_m()) - 1) - m_n),
       m_k(m_n - m_g.degree()),
@@ -76,14 +96,41 @@ bch_codec<T, P>::bch_codec(const galois_field<T>* const gf, uint8_t t, uint32_t
       m_msg_mask(bitmask<T>(m_k)), // k-bit mask
       m_gen_poly_lut_generated(false)
 {
-    if (n > ((static_cast<uint32_t>(1) << gf->get_m()) - 1))
+    init();
+}
+
+template <typename T, typename P>
+bch_codec<T, P>::bch_codec(const bch_codec& other, uint32_t n)
+    : m_gf(other.m_gf),
+      m_t(other.m_t),
+      m_g(other.m_g),
+      m_n(n == 0 ? ((static_cast<uint32_t>(1) << m_gf->get_m()) - 1) : n),
+      m_s(((static_cast<uint32_t>(1) << m_gf->get_m()) - 1) - m_n),
+      m_k(m_n - m_g.degree()),
+      m_parity(m_n - m_k),
+      m_n_bytes(m_n / 8),
+      m_k_bytes(m_k / 8),
+      m_parity_bytes(m_n_bytes - m_k_bytes),
+      m_msg_mask(bitmask<T>(m_k)), // k-bit mask
+      m_gen_poly_rem_lut(other.m_gen_poly_rem_lut),
+      m_gen_poly_lut_generated(other.m_gen_poly_lut_generated),
+      m_quadratic_poly_lut(other.m_quadratic_poly_lut),
+      m_syndrome_lut(other.m_syndrome_lut)
+{
+    init();
+}
+
+template <typename T, typename P>
+void bch_codec<T, P>::init()
+{
+    if (m_n > ((static_cast<uint32_t>(1) << m_gf->get_m()) - 1))
         throw std::runtime_error("Codeword length n exceeds the maximum of (2^m - 1)");
 
     if (static_cast<int>(m_n) <= m_g.degree())
         throw std::runtime_error(
             "Codeword length n must be greater than the generator polynomial's degree");
 
-    if (gf->get_m() > (sizeof(uint32_t) * 8) - 1) // ensure m_n does not overflow
+    if (m_gf->get_m() > (sizeof(uint32_t) * 8) - 1) // ensure m_n does not overflow
         throw std::runtime_error("GF(2^m) dimension m not supported (too large)");
 
     // When k and n are multiples of 8, the message and parity bits are byte-aligned, so
@@ -97,21 +144,52 @@ bch_codec<T, P>::bch_codec(const galois_field<T>* const gf, uint8_t t, uint32_t
     // LUT can only be computed for a g(x) with degree up to (sizeof(P) - 1)*8, as
     // detailed in the implementation of the LUT builder. Hence, to alleviate the issue,
     // compute the LUT only when bytes-based encoding is supported.
-    if (m_k % 8 == 0 || m_n % 8 == 0) {
+    //
+    // The LUTs depend on g(x) only, so a codec constructed from another one reuses them
+    // when available.
+    if ((m_k % 8 == 0 || m_n % 8 == 0) && !m_gen_poly_lut_generated) {
         m_gen_poly_rem_lut = build_gf2_poly_rem_lut(m_g);
         m_gen_poly_lut_generated = true;
+        // The slicing-by-8 LUTs used for syndrome computation hold 64-bit words, so they
+        // support any generator polynomial that fits in type P.
+        m_syndrome_lut = std::make_shared<const std::vector<uint64_t>>(
+            build_gf2_poly_rem_slicing_lut(m_g));
+    } else if (!m_syndrome_lut) {
+        m_syndrome_lut = std::make_shared<const std::vector<uint64_t>>();
     }
 
     // Generate a LUT to solve quadratic error-location polynomials faster than with
     // brute-force root search. See err_loc_numbers() for details.
-    const uint32_t two_to_m = static_cast<uint32_t>(1) << gf->get_m();
-    m_quadratic_poly_lut.resize(two_to_m);
-    for (T r = 0; r < two_to_m; r++) {
-        T idx = m_gf->multiply(r, r) ^ r; // R*(R+1)
-        m_quadratic_poly_lut[idx] = r;
+    if (!m_quadratic_poly_lut) {
+        const uint32_t two_to_m = static_cast<uint32_t>(1) << m_gf->get_m();
+        auto lut = std::make_shared<std::vector<T>>(two_to_m);
+        for (T r = 0; r < two_to_m; r++) {
+            T idx = m_gf->multiply(r, r) ^ r; // R*(R+1)
+            (*lut)[idx] = r;
+        }
+        m_quadratic_poly_lut = std::move(lut);
     }
 }
 
+template <typename T, typename P>
+bch_codec<T, P>::scratch::scratch(const bch_codec& codec)
+    : rem(batch_chunk_size * (codec.m_syndrome_lut->size() / (8 * 256))),
+      syndrome(2 * codec.m_t),
+      sigma((codec.m_t + 2) * 2 * codec.m_t),
+      sigma_degree(codec.m_t + 2),
+      discrepancy(codec.m_t + 2),
+      // Start with 2t non-zero coefficients, the maximum number of coefficients of the
+      // error-location polynomial, so that the polynomial's internal vectors get enough
+      // capacity for the decoder to reassign the polynomial with no memory allocations.
+      err_loc_poly(codec.m_gf, std::vector<T>(2 * codec.m_t, 1))
+{
+    // The error-location numbers are only searched on polynomials of degree up to t.
+    // Also, the bit-sliced root search uses up to four words per bit plane.
+    root_exps.reserve(codec.m_t);
+    chien_workspace.reserve((codec.m_t + 2) * codec.m_gf->get_m() * 4 + codec.m_t + 1);
+    err_loc_numbers.reserve(codec.m_t);
+}
+
 
 // Encode into type T
 template <typename T, typename P>
@@ -217,43 +295,99 @@ template <typename T, typename P>
 std::vector<T> bch_codec<T, P>::syndrome(u8_cptr_t codeword) const
 {
     assert_byte_aligned_n_k(m_n, m_k);
-    const auto parity_poly = gf2_poly_rem(codeword, m_n_bytes, m_g, m_gen_poly_rem_lut);
-    return _eval_syndrome(parity_poly, m_gf, m_t);
+    const int n_words = m_syndrome_lut->size() / (8 * 256);
+    uint64_t rem[4];
+    gf2_poly_rem_sliced(codeword, m_n_bytes, *m_syndrome_lut, rem);
+    if (is_zero_rem(rem, n_words)) // error-free codeword
+        return {};
+
+    std::vector<T> syndrome_vec(2 * m_t);
+    eval_syndrome(rem, syndrome_vec.data());
+    return syndrome_vec;
+}
+
+template <typename T, typename P>
+void bch_codec<T, P>::eval_syndrome(const uint64_t* rem, T* syndrome) const
+{
+    // Remainder of "r(x) * x^d" divided by g(x), where d is the degree of g(x), stored
+    // over n_words words and left-aligned such that the LSB of the least significant
+    // word has the coefficient of x^(64*n_words - d). Hence, the polynomial represented
+    // by the n_words words is "s'(x) = s(x) * x^d * x^(64*n_words - d)", where s(x) is
+    // the remainder of r(x) divided by g(x). Since "s(alpha^i) = r(alpha^i)" (see the
+    // comments above), each syndrome component becomes:
+    //
+    // S_i = s'(alpha^i) * alpha^(-i * 64 * n_words).
+    const int n_words = m_syndrome_lut->size() / (8 * 256);
+
+    // Evaluate the odd components S_1, S_3, ..., S_(2t-1) over the non-zero bits of
+    // s'(x). Bit j contributes with alpha^(i*j) * alpha^(-i * 64 * n_words), i.e., with
+    // alpha^(i * e_j), where "e_j = (j - 64 * n_words) mod (2^m - 1)".
+    const uint32_t two_to_m_minus_one = (static_cast<uint32_t>(1) << m_gf->get_m()) - 1;
+    const uint32_t exp_offset =
+        two_to_m_minus_one - ((64 * n_words) % two_to_m_minus_one);
+    std::fill(syndrome, syndrome + 2 * m_t, 0);
+    for (int w = 0; w < n_words; w++) {
+        for (int b = 0; b < 64; b++) {
+            if (!((rem[w] >> b) & 1))
+                continue;
+            const uint32_t e_j = (64 * w + b + exp_offset) % two_to_m_minus_one;
+            for (int i = 1; i < 2 * m_t; i += 2)
+                syndrome[i - 1] ^= m_gf->get_alpha_i(i * e_j);
+        }
+    }
+
+    // The even components follow from "S_2i = (S_i)^2", which holds for binary codes.
+    for (int i = 2; i <= 2 * m_t; i += 2)
+        syndrome[i - 1] = m_gf->multiply(syndrome[i / 2 - 1], syndrome[i / 2 - 1]);
 }
 
 template <typename T, typename P>
 gf2m_poly<T> bch_codec<T, P>::err_loc_polynomial(const std::vector<T>& syndrome) const
 {
-    T unit = m_gf->get_alpha_i(0);
+    scratch s(*this);
+    err_loc_polynomial(syndrome.data(), s);
+    return s.err_loc_poly;
+}
 
-    // Form a table iteratively with up to t + 2 rows.
-    uint16_t nrows = m_t + 2;
+template <typename T, typename P>
+void bch_codec<T, P>::err_loc_polynomial(const T* syndrome, scratch& s) const
+{
+    T unit = m_gf->get_alpha_i(0);
 
-    // Prefill the values of mu for each row:
-    std::vector<float> mu_vec(nrows);
-    mu_vec[0] = -0.5;
-    for (int i = 0; i < m_t + 1; i++)
-        mu_vec[i + 1] = i;
+    // Form a table iteratively with up to t + 2 rows. Each row holds a candidate
+    // error-location polynomial with up to 2t coefficients (see the degree bound below),
+    // the corresponding discrepancy, and the corresponding value of mu. The first row
+    // has mu = -1/2, and the remaining rows have mu = 0, 1, ..., t. For convenience,
+    // twice the value of mu is used instead of mu.
+    const int n_coefs = 2 * m_t;
+    auto two_mu = [](int row) { return (row == 0) ? -1 : 2 * (row - 1); };
+    T* sigma = s.sigma.data();
+    int* degree = s.sigma_degree.data();
+    T* d = s.discrepancy.data();
 
     // Iteratively computed error-location polynomial.
     //
     // The first two rows are prefilled with "sigma(x) = 1". The third row can be
     // prefilled with the first-degree polynomial "S[0]*x + 1", where S[0] is the first
     // syndrome element.
-    std::vector<gf2m_poly<T>> sigma_vec = { gf2m_poly<T>(m_gf, std::vector<T>({ unit })),
-                                            gf2m_poly<T>(m_gf, std::vector<T>({ unit })),
-                                            gf2m_poly<T>(m_gf, { unit, syndrome[0] }) };
+    std::fill(sigma, sigma + 3 * n_coefs, 0);
+    sigma[0] = unit;
+    sigma[n_coefs] = unit;
+    sigma[2 * n_coefs] = unit;
+    sigma[2 * n_coefs + 1] = syndrome[0];
+    degree[0] = 0;
+    degree[1] = 0;
+    degree[2] = (syndrome[0] != 0) ? 1 : 0;
 
     // Discrepancy, a GF(2^m) value. The first two rows have discrepancies equal to 1 and
     // S[0] (first syndrome component), respectively.
-    std::vector<T> d(nrows);
     d[0] = unit;
     d[1] = syndrome[0];
 
     int row = 2;
     while (row <= m_t) {
-        float mu = mu_vec[row];
-        int two_mu = 2 * mu;
+        const int two_mu_row = two_mu(row);
+        const T* sigma_row = sigma + row * n_coefs;
 
         // Discrepancy from equation (6.42) of Lin & Costello's book
         //
@@ -262,17 +396,17 @@ gf2m_poly<T> bch_codec<T, P>::err_loc_polynomial(const std::vector<T>& syndrome)
         // S_(2*mu + 1)". Also, note the formulation considers syndrome components S_1 to
         // S_2t, which is S[0] to S[2*t - 1] here. Thus, in the end, S_(2mu + 3) from
         // (6.42) becomes S[2*mu] below, while S_(2mu + 2) becomes S[2*mu - 1], and so on.
-        d[row] = syndrome[two_mu]; // e.g., for mu=1, pick S[2]
-        const auto& sigma = sigma_vec[row].get_poly();
-        for (size_t j = 1; j < sigma.size(); j++) { // exclude the zero-degree term
-            if (sigma[j] != 0)                      // j-th coefficient
-                d[row] ^= m_gf->multiply(sigma[j], syndrome[two_mu - j]);
+        d[row] = syndrome[two_mu_row];           // e.g., for mu=1, pick S[2]
+        for (int j = 1; j <= degree[row]; j++) { // exclude the zero-degree term
+            if (sigma_row[j] != 0)               // j-th coefficient
+                d[row] ^= m_gf->multiply(sigma_row[j], syndrome[two_mu_row - j]);
         }
 
         // Next candidate polynomial
-        if (d[row] == 0)
-            sigma_vec.push_back(sigma_vec[row]);
-        else {
+        T* sigma_next = sigma + (row + 1) * n_coefs;
+        std::copy(sigma_row, sigma_row + n_coefs, sigma_next);
+        degree[row + 1] = degree[row];
+        if (d[row] != 0) {
             // Find another row rho prior to the μ-th row such that the rho-th discrepancy
             // d[rho] is not zero and the difference between twice the row number (2*rho)
             // and the degree of sigma at this row has the largest value
@@ -280,45 +414,62 @@ gf2m_poly<T> bch_codec<T, P>::err_loc_polynomial(const std::vector<T>& syndrome)
             int max_diff = -2; // maximum diff "2*rho - sigma[row_rho].degree"
             for (int j = row - 1; j >= 0; j--) {
                 if (d[j] != 0) { // discrepancy is not zero
-                    int diff = (2 * mu_vec[j]) - sigma_vec[j].degree();
+                    int diff = two_mu(j) - degree[j];
                     if (diff > max_diff) {
                         max_diff = diff;
                         row_rho = j;
                     }
                 }
             }
-            float rho = mu_vec[row_rho]; // value of mu at the rho-th row
 
             // Equation (6.41)
-            T d_mu_inv_d_rho = m_gf->divide(d[row], d[row_rho]);
-            std::vector<T> x_two_mu_minus_rho_coefs(int(2 * (mu - rho)));
-            x_two_mu_minus_rho_coefs.push_back(1);
-            const auto x_two_mu_minus_rho =
-                gf2m_poly<T>(m_gf, std::move(x_two_mu_minus_rho_coefs));
-            sigma_vec.push_back(sigma_vec[row] + (x_two_mu_minus_rho * d_mu_inv_d_rho *
-                                                  sigma_vec[row_rho]));
+            //
+            // The product "x^(2*(mu - rho)) * sigma_rho(x)" has degree equal to "2*mu -
+            // max_diff", and since the first row alone already gives "max_diff >= -1",
+            // the degree is at most "2*mu + 1 = 2*t - 1" on the last iteration.
+            const T d_mu_inv_d_rho = m_gf->divide(d[row], d[row_rho]);
+            const T* sigma_rho = sigma + row_rho * n_coefs;
+            const int shift = two_mu_row - two_mu(row_rho); // 2*(mu - rho)
+            for (int j = 0; j <= degree[row_rho]; j++)
+                sigma_next[j + shift] ^= m_gf->multiply(d_mu_inv_d_rho, sigma_rho[j]);
+            int next_degree = std::max(degree[row], shift + degree[row_rho]);
+            while (next_degree > 0 && sigma_next[next_degree] == 0)
+                next_degree--;
+            degree[row + 1] = next_degree;
         }
         row += 1;
     }
-    return sigma_vec[row];
+    s.err_loc_poly.assign(sigma + row * n_coefs, degree[row] + 1);
 }
 
 template <typename T, typename P>
 std::vector<T> bch_codec<T, P>::err_loc_numbers(const gf2m_poly<T>& sigma) const
 {
+    scratch s(*this);
+    err_loc_numbers(sigma, s);
+    return s.err_loc_numbers;
+}
+
+template <typename T, typename P>
+void bch_codec<T, P>::err_loc_numbers(const gf2m_poly<T>& sigma, scratch& s) const
+{
+    std::vector<T>& numbers = s.err_loc_numbers;
+    numbers.clear();
+
     // If the error-location polynomial sigma has degree greater than t, that means there
     // were more than t errors, and, in general, the errors cannot be located. Hence,
     // there is no point in going through the expensive computation of the error-location
     // numbers. Instead, the decoder should just skip the error correction step.
     if (sigma.degree() > m_t)
-        return {};
+        return;
 
     if (sigma.degree() == 1) {
         // An unitary-degree error-location polynomial has a single root that can be
         // solved immediately with no need for a brute-force search. The polynomial can be
         // expressed as "ax + b", whose root is "b/a". Correspondingly, the error-location
         // number (reciprocal of the root) is "a/b".
-        return { m_gf->divide(sigma[1], sigma[0]) };
+        numbers.push_back(m_gf->divide(sigma[1], sigma[0]));
+        return;
     }
 
     if (sigma.degree() == 2) {
@@ -357,31 +508,37 @@ std::vector<T> bch_codec<T, P>::err_loc_numbers(const gf2m_poly<T>& sigma) const
         // roots would both be zero (non-invertible). In any of these cases, return early
         // with an empty vector of error-location numbers (meaning decoding failure).
         if (sigma[1] == 0 || sigma[0] == 0) // b=0 or c=0
-            return {};
+            return;
         T b_over_a = m_gf->divide(sigma[1], sigma[2]);
         T r_sq_plus_r = m_gf->divide(m_gf->multiply(sigma[0], sigma[2]),
                                      m_gf->multiply(sigma[1], sigma[1]));
-        T r = m_quadratic_poly_lut[r_sq_plus_r];
+        T r = (*m_quadratic_poly_lut)[r_sq_plus_r];
+        // Only half of the GF(2^m) elements can be expressed as R*(R+1). The LUT entries
+        // of the other elements are zero (as R=0 itself maps to index zero, which can't
+        // be hit when c and a are non-zero). In this case, the polynomial has no roots
+        // in GF(2^m), i.e., there are more than t errors, and x0 would be zero, which is
+        // non-invertible.
+        if (r == 0)
+            return;
         T x0 = m_gf->multiply(r, b_over_a);
         T x1 = m_gf->multiply(b_over_a, (r ^ 1));
-        return { m_gf->inverse(x0), m_gf->inverse(x1) };
+        numbers.push_back(m_gf->inverse(x0));
+        numbers.push_back(m_gf->inverse(x1));
+        return;
     }
 
     // Given the codeword has length n, the error location numbers can range from alpha^0
     // to alpha^n-1. Since alpha^(n+s) = alpha^(2^m - 1) = 1, the corresponding inverses
     // range from alpha^(n+s) to alpha^(s+1). See if any of these are the roots of sigma
-    // and record the results.
-    //
-    // TODO: optimize this computation using a strategy like the one in Fig. 6.1.
-    std::vector<uint32_t> root_exps =
-        sigma.search_roots_in_exp_range(m_s + 1,       // starting exponent
-                                        m_n + m_s,     // ending exponent
-                                        sigma.degree() // max number of roots to find
-        );
-    std::vector<T> numbers(root_exps.size());
-    for (size_t i = 0; i < root_exps.size(); i++)
-        numbers[i] = m_gf->inverse_by_exp(root_exps[i]);
-    return numbers;
+    // and record the results. Over the long ranges of the DVB-S2 codes, this is a
+    // bit-sliced Chien search, which stops as soon as deg(sigma) roots are found.
+    sigma.search_roots_in_exp_range(m_s + 1,        // starting exponent
+                                    m_n + m_s,      // ending exponent
+                                    sigma.degree(), // max number of roots to find
+                                    s.root_exps,
+                                    s.chien_workspace);
+    for (uint32_t root_exp : s.root_exps)
+        numbers.push_back(m_gf->inverse_by_exp(root_exp));
 }
 
 /**
@@ -466,23 +623,87 @@ T bch_codec<T, P>::decode(T codeword) const
 
 template <typename T, typename P>
 int bch_codec<T, P>::decode(u8_cptr_t codeword, u8_ptr_t decoded_msg) const
+{
+    int corrections;
+    decode_batch(codeword, decoded_msg, 1, &corrections);
+    return corrections;
+}
+
+template <typename T, typename P>
+void bch_codec<T, P>::decode_batch(u8_cptr_t codewords,
+                                   u8_ptr_t decoded_msgs,
+                                   size_t n_codewords,
+                                   int* corrections,
+                                   scratch& s) const
 {
     assert_byte_aligned_n_k(m_n, m_k);
-    memcpy(decoded_msg, codeword, m_k_bytes); // systematic bytes
-    const auto s = syndrome(codeword);
-    if (s.size() > 0) { // an empty syndrome means no errors
-        const auto poly = err_loc_polynomial(s);
-        const auto numbers = err_loc_numbers(poly);
-        correct_errors(decoded_msg, m_n, m_k, m_gf, numbers);
-        // Generally, the error location polynomial has degree greater than t when the
-        // codeword has more than t errors, in which case the errors cannot be located.
-        // Also, even if the error location polynomial has degree <= t, not necessarily
-        // all error location numbers can be found. The err_loc_numbers function should
-        // obtain a number of error location numbers equivalent to the degree of the error
-        // location polynomial. Otherwise, not all errors can be corrected.
-        return poly.degree() == static_cast<int>(numbers.size()) ? numbers.size() : -1;
-    } else {
-        return 0;
+    const int n_words = m_syndrome_lut->size() / (8 * 256);
+
+    // Compute the syndrome remainders of a few codewords at once, then decode each of
+    // them while they are still in cache. Only the codewords with a non-zero remainder
+    // go through the rest of the decoding algorithm.
+    for (size_t i_chunk = 0; i_chunk < n_codewords; i_chunk += batch_chunk_size) {
+        const size_t chunk_size = std::min(batch_chunk_size, n_codewords - i_chunk);
+        u8_cptr_t chunk = codewords + i_chunk * m_n_bytes;
+        gf2_poly_rem_sliced_batch(
+            chunk, m_n_bytes, chunk_size, *m_syndrome_lut, s.rem.data());
+
+        for (size_t i = 0; i < chunk_size; i++) {
+            u8_cptr_t codeword = chunk + i * m_n_bytes;
+            u8_ptr_t decoded_msg = decoded_msgs + (i_chunk + i) * m_k_bytes;
+            const uint64_t* rem = s.rem.data() + i * n_words;
+            int& n_corrected = corrections[i_chunk + i];
+            memcpy(decoded_msg, codeword, m_k_bytes); // systematic bytes
+            if (is_zero_rem(rem, n_words)) {          // no errors
+                n_corrected = 0;
+                continue;
+            }
+            eval_syndrome(rem, s.syndrome.data());
+            err_loc_polynomial(s.syndrome.data(), s);
+            err_loc_numbers(s.err_loc_poly, s);
+            correct_errors(decoded_msg, m_n, m_k, m_gf, s.err_loc_numbers);
+            // Generally, the error location polynomial has degree greater than t when
+            // the codeword has more than t errors, in which case the errors cannot be
+            // located. Also, even if the error location polynomial has degree <= t, not
+            // necessarily all error location numbers can be found. The err_loc_numbers
+            // function should obtain a number of error location numbers equivalent to
+            // the degree of the error location polynomial. Otherwise, not all errors can
+            // be corrected.
+            const int n_numbers = s.err_loc_numbers.size();
+            n_corrected = (s.err_loc_poly.degree() == n_numbers) ? n_numbers : -1;
+        }
+    }
+}
+
+template <typename T, typename P>
+void bch_codec<T, P>::decode_batch(u8_cptr_t codewords,
+                                   u8_ptr_t decoded_msgs,
+                                   size_t n_codewords,
+                                   int* corrections) const
+{
+    scratch s(*this);
+    decode_batch(codewords, decoded_msgs, n_codewords, corrections, s);
+}
+
+template <typename T, typename P>
+void bch_codec<T, P>::check_batch(u8_cptr_t codewords,
+                                  u8_ptr_t msgs,
+                                  size_t n_codewords,
+                                  int* status,
+                                  scratch& s) const
+{
+    assert_byte_aligned_n_k(m_n, m_k);
+    const int n_words = m_syndrome_lut->size() / (8 * 256);
+    for (size_t i_chunk = 0; i_chunk < n_codewords; i_chunk += batch_chunk_size) {
+        const size_t chunk_size = std::min(batch_chunk_size, n_codewords - i_chunk);
+        u8_cptr_t chunk = codewords + i_chunk * m_n_bytes;
+        gf2_poly_rem_sliced_batch(
+            chunk, m_n_bytes, chunk_size, *m_syndrome_lut, s.rem.data());
+        for (size_t i = 0; i < chunk_size; i++) {
+            memcpy(msgs + (i_chunk + i) * m_k_bytes, chunk + i * m_n_bytes, m_k_bytes);
+            const uint64_t* rem = s.rem.data() + i * n_words;
+            status[i_chunk + i] = is_zero_rem(rem, n_words) ? 0 : -1;
+        }
     }
 }
 
@@ -14,6 +14,7 @@
 #include <gnuradio/dvbs2rx/api.h>
 #include <array>
 #include <cstdint>
+#include <memory>
 
 namespace gr {
 namespace dvbs2rx {
@@ -42,7 +43,72 @@ private:
     std::array<P, 256> m_gen_poly_rem_lut; // Remainder LUT for the generator polynomial
     bool m_gen_poly_lut_generated; // Whether the generator polynomial remainder LUT has
                                    // been generated already
-    std::vector<T> m_quadratic_poly_lut; // LUT to solve quadratic error-loc polynomials
+    // LUT to solve quadratic error-loc polynomials, shared by codecs of the same field
+    std::shared_ptr<const std::vector<T>> m_quadratic_poly_lut;
+    // Slicing-by-8 remainder LUTs for the syndrome, shared by codecs of the same g(x)
+    std::shared_ptr<const std::vector<uint64_t>> m_syndrome_lut;
+
+public:
+    /**
+     * @brief Working memory for the decoder.
+     *
+     * Holds the intermediate results of the decoding algorithm, preallocated for a given
+     * codec, such that decode_batch() can decode with no memory allocations.
+     *
+     * @note A scratch object must not be used by multiple threads simultaneously.
+     */
+    class scratch
+    {
+    private:
+        friend class bch_codec;
+        std::vector<uint64_t> rem;             // Syndrome remainders of the codewords
+        std::vector<T> syndrome;               // Syndrome components
+        std::vector<T> sigma;                  // Berlekamp's table of polynomials
+        std::vector<int> sigma_degree;         // Degrees of the polynomials in the table
+        std::vector<T> discrepancy;            // Discrepancies of Berlekamp's table
+        gf2m_poly<T> err_loc_poly;             // Resulting error-location polynomial
+        std::vector<uint32_t> root_exps;       // Exponents of the polynomial roots
+        std::vector<uint64_t> chien_workspace; // Working memory of the root search
+        std::vector<T> err_loc_numbers;        // Error-location numbers
+
+    public:
+        /**
+         * @brief Construct the working memory for a given codec.
+         *
+         * @param codec Reference BCH codec.
+         */
+        explicit scratch(const bch_codec& codec);
+    };
+
+private:
+    /**
+     * @brief Validate the code parameters and generate the LUTs not generated yet.
+     */
+    void init();
+
+    /**
+     * @brief Evaluate the syndrome components from the codeword remainder.
+     *
+     * @param rem Non-zero codeword remainder computed by gf2_poly_rem_sliced().
+     * @param syndrome Output array with space for 2t syndrome components.
+     */
+    void eval_syndrome(const uint64_t* rem, T* syndrome) const;
+
+    /**
+     * @brief Compute the error-location polynomial into the given working memory.
+     *
+     * @param syndrome Array with 2t syndrome components.
+     * @param s Working memory, where the resulting polynomial is stored.
+     */
+    void err_loc_polynomial(const T* syndrome, scratch& s) const;
+
+    /**
+     * @brief Compute the error-location numbers into the given working memory.
+     *
+     * @param sigma Error location polynomial.
+     * @param s Working memory, where the resulting numbers are stored.
+     */
+    void err_loc_numbers(const gf2m_poly<T>& sigma, scratch& s) const;
 
 public:
     /**
@@ -60,6 +126,35 @@ public:
      */
     bch_codec(const galois_field<T>* const gf, uint8_t t, uint32_t n = 0);
 
+    /**
+     * @overload
+     * @param gf Reference Galois field.
+     * @param t Target error correction capability.
+     * @param n Target codeword length in bits.
+     * @param g Precomputed generator polynomial, which must be the one the other
+     * constructor computes for the given field and t.
+     * @note This constructor skips the computation of the minimal polynomials of the
+     * field, which is the slowest part of the construction for large fields.
+     */
+    bch_codec(const galois_field<T>* const gf,
+              uint8_t t,
+              uint32_t n,
+              const gf2_poly<P>& g);
+
+    /**
+     * @brief Construct a codec for another codeword length of an existing code.
+     *
+     * The new codec shares the Galois field, the generator polynomial, and the LUTs of
+     * the reference codec, which depend on the field and the generator polynomial only.
+     * Hence, the shortened codes of the same mother code, such as the BCH codes used
+     * with the various code rates of a FECFRAME size in DVB-S2, can be constructed
+     * quickly and without duplicating the LUTs in memory.
+     *
+     * @param other Reference codec.
+     * @param n Target codeword length in bits.
+     */
+    bch_codec(const bch_codec& other, uint32_t n);
+
     /**
      * @brief Encode an input message.
      *
@@ -102,6 +197,9 @@ public:
     /**
      * @overload
      * @param codeword Pointer to u8 array with the received codeword.
+     * @note This implementation computes the syndrome directly from the codeword bytes,
+     * eight bytes at a time, and evaluates only the odd syndrome components, given that
+     * each even component S_2i is the square of S_i.
      */
     std::vector<T> syndrome(u8_cptr_t codeword) const;
 
@@ -150,6 +248,64 @@ public:
      */
     int decode(u8_cptr_t codeword, u8_ptr_t decoded_msg) const;
 
+    /**
+     * @brief Decode a batch of codewords.
+     *
+     * @param codewords Pointer to the received codewords with n/8 bytes each, stored
+     * back-to-back.
+     * @param decoded_msgs Pointer to the decoded messages buffer with space for k/8 bytes
+     * per codeword.
+     * @param n_codewords Number of codewords to decode.
+     * @param corrections Pointer to the output array with the number of bit errors
+     * corrected on each codeword, following the same convention as the return value of
+     * decode(): 0 when the message is error-free and -1 on decoding failure.
+     * @param s Working memory reused across calls.
+     * @note The syndrome remainders are computed for several codewords at once, so the
+     * error-free codewords, which are typically the majority, are decoded faster than
+     * with one decode() call per codeword. Also, no memory is allocated.
+     * @note This bytes-based decoding is only supported when n and k are multiples of 8.
+     */
+    void decode_batch(u8_cptr_t codewords,
+                      u8_ptr_t decoded_msgs,
+                      size_t n_codewords,
+                      int* corrections,
+                      scratch& s) const;
+
+    /**
+     * @overload
+     * @note This overload allocates the working memory on every call. Keep a scratch
+     * object and use the other overload to avoid that.
+     */
+    void decode_batch(u8_cptr_t codewords,
+                      u8_ptr_t decoded_msgs,
+                      size_t n_codewords,
+                      int* corrections) const;
+
+    /**
+     * @brief Check a batch of codewords without correcting them.
+     *
+     * Computes only the syndrome remainder of each codeword, which is zero for a valid
+     * codeword, and copies the systematic (message) bytes to the output unchanged. This
+     * is meant for codewords already expected to be error-free, e.g., when an outer LDPC
+     * decoder converged, in which case a non-zero remainder more likely indicates an
+     * LDPC undetected error beyond the BCH correction capability.
+     *
+     * @param codewords Pointer to the received codewords with n/8 bytes each, stored
+     * back-to-back.
+     * @param msgs Pointer to the output messages buffer with space for k/8 bytes per
+     * codeword.
+     * @param n_codewords Number of codewords to check.
+     * @param status Pointer to the output array with the status of each codeword, 0 when
+     * it is a valid codeword and -1 otherwise, as in the decode_batch() corrections.
+     * @param s Working memory reused across calls.
+     * @note This bytes-based check is only supported when n and k are multiples of 8.
+     */
+    void check_batch(u8_cptr_t codewords,
+                     u8_ptr_t msgs,
+                     size_t n_codewords,
+                     int* status,
+                     scratch& s) const;
+
     /**
      * @brief Get the generator polynomial object.
      *
@@ -0,0 +1,201 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "bch_codes.h"
+#include "fec_params.h"
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace gr {
+namespace dvbs2rx {
+
+namespace {
+
+const uint8_t max_t = 12;
+
+struct bch_field_def_t {
+    uint32_t prim_poly;
+    // Minimal polynomials of alpha^1, alpha^3, ..., alpha^23, which are the polynomials
+    // g_1(x) to g_12(x) listed in the standards. The generator polynomial of the
+    // t-error-correcting code is the product of the first t of them.
+    uint32_t min_polys[max_t];
+};
+
+// EN 302 307-1, Table 6a
+const bch_field_def_t normal_field = { 0x1002d,
+                                       { 0x1002d,
+                                         0x10173,
+                                         0x10fbd,
+                                         0x15a55,
+                                         0x11f2f,
+                                         0x1f7b5,
+                                         0x1af65,
+                                         0x17367,
+                                         0x10ea1,
+                                         0x175a7,
+                                         0x13a2d,
+                                         0x11ae3 } };
+
+// EN 302 307-1, Table 6b
+const bch_field_def_t short_field = { 0x402b,
+                                      { 0x402b,
+                                        0x4941,
+                                        0x4647,
+                                        0x5591,
+                                        0x6b55,
+                                        0x6389,
+                                        0x6ce5,
+                                        0x4f21,
+                                        0x460f,
+                                        0x5a49,
+                                        0x5811,
+                                        0x65ef } };
+
+// EN 302 307-2, medium FECFRAME
+const bch_field_def_t medium_field = { 0x802d,
+                                       { 0x802d,
+                                         0x8c93,
+                                         0xb555,
+                                         0x8d6d,
+                                         0x94d7,
+                                         0xb0d1,
+                                         0xd8b5,
+                                         0xcb55,
+                                         0xbab7,
+                                         0xbc9f,
+                                         0x8a17,
+                                         0xed15 } };
+
+const bch_field_def_t& get_field_def(dvb_framesize_t framesize)
+{
+    if (framesize == FECFRAME_NORMAL)
+        return normal_field;
+    else if (framesize == FECFRAME_SHORT)
+        return short_field;
+    else
+        return medium_field;
+}
+
+// A shared codec along with the Galois field it points to, so that the field lives as
+// long as any of its codecs.
+struct bch_codec_entry_t {
+    std::shared_ptr<const galois_field<uint32_t>> gf;
+    dvb_bch_codec_t codec;
+
+    bch_codec_entry_t(std::shared_ptr<const galois_field<uint32_t>> gf,
+                      uint8_t t,
+                      uint32_t n,
+                      const gf2_poly<bitset256_t>& g)
+        : gf(std::move(gf)), codec(this->gf.get(), t, n, g)
+    {
+    }
+
+    bch_codec_entry_t(std::shared_ptr<const galois_field<uint32_t>> gf,
+                      const dvb_bch_codec_t& other,
+                      uint32_t n)
+        : gf(std::move(gf)), codec(other, n)
+    {
+    }
+};
+
+// Process-wide cache of the codecs, keyed by FECFRAME size, error correction capability,
+// and codeword length, and of their Galois fields, keyed by FECFRAME size. The entries
+// are weak references, so a codec lives as long as its users.
+typedef std::tuple<dvb_framesize_t, uint32_t, uint32_t> bch_cache_key_t;
+std::mutex cache_mutex;
+std::map<bch_cache_key_t, std::weak_ptr<const dvb_bch_codec_t>> codec_cache;
+std::map<dvb_framesize_t, std::weak_ptr<const galois_field<uint32_t>>> field_cache;
+uint64_t cache_hits = 0;
+uint64_t cache_misses = 0;
+
+std::shared_ptr<const galois_field<uint32_t>> get_field(dvb_framesize_t framesize)
+{
+    auto it = field_cache.find(framesize);
+    if (it != field_cache.end()) {
+        if (auto gf = it->second.lock())
+            return gf;
+    }
+    auto gf = std::make_shared<const galois_field<uint32_t>>(
+        gf2_poly<uint32_t>(get_field_def(framesize).prim_poly));
+    field_cache[framesize] = gf;
+    return gf;
+}
+} // namespace
+
+uint32_t get_bch_prim_poly(dvb_framesize_t framesize)
+{
+    return get_field_def(framesize).prim_poly;
+}
+
+gf2_poly<bitset256_t> get_bch_gen_poly(dvb_framesize_t framesize, uint8_t t)
+{
+    if (t > max_t)
+        throw std::runtime_error("Unsupported BCH error correction capability");
+    const bch_field_def_t& def = get_field_def(framesize);
+    gf2_poly<bitset256_t> g(1);
+    for (uint8_t i = 0; i < t; i++)
+        g = g * gf2_poly<bitset256_t>(def.min_polys[i]);
+    return g;
+}
+
+std::shared_ptr<const dvb_bch_codec_t>
+get_bch_codec(dvb_standard_t standard, dvb_framesize_t framesize, dvb_code_rate_t rate)
+{
+    fec_info_t fec_info = {};
+    get_fec_info(standard, framesize, rate, fec_info);
+    if (fec_info.bch.n == 0 || fec_info.bch.t > max_t)
+        return nullptr;
+    const uint8_t t = fec_info.bch.t;
+    const uint32_t n = fec_info.bch.n;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    const bch_cache_key_t key(framesize, t, n);
+    auto it = codec_cache.find(key);
+    if (it != codec_cache.end()) {
+        if (auto codec = it->second.lock()) {
+            cache_hits++;
+            return codec;
+        }
+    }
+
+    // Derive the codec from another one of the same mother code, if any, to share its
+    // LUTs. Otherwise, construct it from the precomputed generator polynomial.
+    std::shared_ptr<const dvb_bch_codec_t> sibling;
+    for (auto sib_it = codec_cache.lower_bound(bch_cache_key_t(framesize, t, 0));
+         sib_it != codec_cache.end() && std::get<0>(sib_it->first) == framesize &&
+         std::get<1>(sib_it->first) == t && !sibling;
+         sib_it++) {
+        sibling = sib_it->second.lock();
+    }
+    auto gf = get_field(framesize);
+    auto entry = sibling ? std::make_shared<const bch_codec_entry_t>(gf, *sibling, n)
+                         : std::make_shared<const bch_codec_entry_t>(
+                               gf, t, n, get_bch_gen_poly(framesize, t));
+    // Share the ownership of the entry while pointing to the codec
+    std::shared_ptr<const dvb_bch_codec_t> codec(entry, &entry->codec);
+    codec_cache[key] = codec;
+    cache_misses++;
+    return codec;
+}
+
+bch_cache_stats_t get_bch_cache_stats()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    bch_cache_stats_t stats = { cache_hits, cache_misses, 0, 0 };
+    for (const auto& entry : codec_cache)
+        stats.codecs += !entry.second.expired();
+    for (const auto& entry : field_cache)
+        stats.fields += !entry.second.expired();
+    return stats;
+}
+
+} // namespace dvbs2rx
+} // namespace gr
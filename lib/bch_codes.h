@@ -0,0 +1,86 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DVBS2RX_BCH_CODES_H
+#define INCLUDED_DVBS2RX_BCH_CODES_H
+
+#include "bch.h"
+#include <gnuradio/dvbs2rx/api.h>
+#include <gnuradio/dvbs2rx/dvb_config.h>
+#include <cstdint>
+#include <memory>
+
+namespace gr {
+namespace dvbs2rx {
+
+typedef bch_codec<uint32_t, bitset256_t> dvb_bch_codec_t;
+
+/**
+ * @brief Get the primitive polynomial of the Galois field used by the BCH codes of a
+ * FECFRAME size.
+ *
+ * @param framesize FECFRAME size.
+ * @return uint32_t Primitive polynomial of degree 16 (normal), 14 (short), or 15
+ * (medium FECFRAME).
+ */
+DVBS2RX_API uint32_t get_bch_prim_poly(dvb_framesize_t framesize);
+
+/**
+ * @brief Get the precomputed generator polynomial of a DVB BCH code.
+ *
+ * The generator polynomial is the product of the first t minimal polynomials tabulated
+ * in the DVB-S2 and DVB-S2X standards for the FECFRAME size, so it does not require
+ * computing the minimal polynomials from the Galois field.
+ *
+ * @param framesize FECFRAME size.
+ * @param t Error correction capability (up to 12).
+ * @return gf2_poly<bitset256_t> Generator polynomial.
+ */
+DVBS2RX_API gf2_poly<bitset256_t> get_bch_gen_poly(dvb_framesize_t framesize, uint8_t t);
+
+/**
+ * @brief Statistics of the process-wide BCH codec cache.
+ */
+struct bch_cache_stats_t {
+    uint64_t hits;   /**< Lookups served by an already constructed codec */
+    uint64_t misses; /**< Lookups that constructed a new codec */
+    size_t codecs;   /**< Number of codecs currently in use */
+    size_t fields;   /**< Number of Galois fields currently in use */
+};
+
+/**
+ * @brief Get the BCH codec of a DVB FEC configuration from the process-wide cache.
+ *
+ * The codec is immutable and shared by all decoders of the same code, across block
+ * instances and threads, with each decoder keeping its own working memory (see
+ * bch_codec::scratch). Furthermore, the codecs of a FECFRAME size share the same Galois
+ * field, and the codecs with the same error correction capability (i.e., the shortened
+ * versions of the same mother code) share their LUTs. The cache holds no ownership:
+ * each codec is constructed on the first lookup and released once the last user drops
+ * it. This function is thread-safe.
+ *
+ * @param standard DVB standard (DVB-S2, DVB-S2X, or DVB-T2).
+ * @param framesize FECFRAME size.
+ * @param rate Code rate.
+ * @return std::shared_ptr<const dvb_bch_codec_t> Shared codec, or nullptr if the code
+ * configuration is not supported.
+ */
+DVBS2RX_API std::shared_ptr<const dvb_bch_codec_t>
+get_bch_codec(dvb_standard_t standard, dvb_framesize_t framesize, dvb_code_rate_t rate);
+
+/**
+ * @brief Get the hit and miss counts of the process-wide BCH codec cache.
+ * @return bch_cache_stats_t Cache statistics.
+ */
+DVBS2RX_API bch_cache_stats_t get_bch_cache_stats();
+
+} // namespace dvbs2rx
+} // namespace gr
+
+#endif // INCLUDED_DVBS2RX_BCH_CODES_H
@@ -16,7 +16,10 @@
 #include "fec_params.h"
 #include <gnuradio/io_signature.h>
 #include <gnuradio/logger.h>
+#include <algorithm>
+#include <cstring>
 #include <functional>
+#include <stdexcept>
 // BCH Code
 #define BCH_CODE_N8 0
 #define BCH_CODE_N10 1
@@ -31,10 +34,17 @@ bch_decoder_bb::sptr bch_decoder_bb::make(dvb_standard_t standard,
                                           dvb_framesize_t framesize,
                                           dvb_code_rate_t rate,
                                           dvb_outputmode_t outputmode,
-                                          int debug_level)
+                                          int debug_level,
+                                          dvb_bch_converged_t converged_mode,
+                                          int num_threads)
 {
-    return gnuradio::get_initial_sptr(
-        new bch_decoder_bb_impl(standard, framesize, rate, outputmode, debug_level));
+    return gnuradio::get_initial_sptr(new bch_decoder_bb_impl(standard,
+                                                              framesize,
+                                                              rate,
+                                                              outputmode,
+                                                              debug_level,
+                                                              converged_mode,
+                                                              num_threads));
 }
 
 /*
@@ -44,26 +54,23 @@ bch_decoder_bb_impl::bch_decoder_bb_impl(dvb_standard_t standard,
                                          dvb_framesize_t framesize,
                                          dvb_code_rate_t rate,
                                          dvb_outputmode_t outputmode,
-                                         int debug_level)
+                                         int debug_level,
+                                         dvb_bch_converged_t converged_mode,
+                                         int num_threads)
     : gr::block("bch_decoder_bb",
                 gr::io_signature::make(1, 1, sizeof(unsigned char)),
                 gr::io_signature::make(1, 1, sizeof(unsigned char))),
       d_debug_level(debug_level),
+      d_converged_mode(converged_mode),
       d_frame_cnt(0),
       d_frame_error_cnt(0)
 {
     fec_info_t fec_info;
     get_fec_info(standard, framesize, rate, fec_info);
-    uint32_t prim_poly;
-    if (framesize == FECFRAME_NORMAL)
-        prim_poly = 0b10000000000101101; // x^16 + x^5 + x^3 + x^2 + 1
-    else if (framesize == FECFRAME_SHORT)
-        prim_poly = 0b100000000101011; // x^14 + x^5 + x^3 + x + 1
-    else
-        prim_poly = 0b1000000000101101; // x^15 + x^5 + x^3 + x^2 + 1
-    d_gf = std::make_unique<galois_field<uint32_t>>(prim_poly);
-    d_codec = std::make_unique<bch_codec<uint32_t, bitset256_t>>(
-        d_gf.get(), fec_info.bch.t, fec_info.bch.n);
+    d_codec = get_bch_codec(standard, framesize, rate);
+    if (!d_codec)
+        throw std::runtime_error("Unsupported BCH code configuration");
+    d_pool = std::make_unique<bch_decoder_pool>(d_codec, num_threads);
     d_k_bytes = fec_info.bch.k / 8;
     d_n_bytes = fec_info.bch.n / 8;
     set_output_multiple(d_k_bytes);
@@ -89,10 +96,53 @@ int bch_decoder_bb_impl::general_work(int noutput_items,
     const unsigned char* in = (const unsigned char*)input_items[0];
     unsigned char* out = (unsigned char*)output_items[0];
 
-    int consumed = 0;
     int n_codewords = noutput_items / d_k_bytes;
+    if (d_corrections.size() < static_cast<size_t>(n_codewords)) {
+        d_corrections.resize(n_codewords);
+        d_converged.resize(n_codewords);
+    }
+
+    // Flag the codewords whose LDPC decoding converged, according to the status tag
+    // placed by the LDPC decoder at the start of each frame
+    std::fill(d_converged.begin(), d_converged.begin() + n_codewords, 0);
+    if (d_converged_mode != BCH_CONVERGED_DECODE) {
+        std::vector<tag_t> tags;
+        get_tags_in_window(tags, 0, 0, n_codewords * d_n_bytes, d_ldpc_status_tag_key);
+        for (const tag_t& tag : tags) {
+            const uint64_t rel_offset = tag.offset - nitems_read(0);
+            if (rel_offset % d_n_bytes != 0 || !pmt::is_pair(tag.value) ||
+                !pmt::is_bool(pmt::car(tag.value)))
+                continue;
+            d_converged[rel_offset / d_n_bytes] = pmt::to_bool(pmt::car(tag.value));
+        }
+    }
+
+    // Process each run of consecutive codewords with the same convergence status at
+    // once. The converged codewords are only checked or copied, depending on the mode,
+    // and the others go through the full decoding.
+    for (int i = 0; i < n_codewords;) {
+        const bool converged = d_converged[i];
+        int n_run = 1;
+        while (i + n_run < n_codewords && d_converged[i + n_run] == converged)
+            n_run++;
+        const unsigned char* run_in = in + i * d_n_bytes;
+        unsigned char* run_out = out + i * d_k_bytes;
+        int* run_corrections = d_corrections.data() + i;
+        if (!converged) {
+            d_pool->decode_batch(run_in, run_out, n_run, run_corrections);
+        } else if (d_converged_mode == BCH_CONVERGED_CHECK) {
+            d_codec->check_batch(
+                run_in, run_out, n_run, run_corrections, d_pool->scratch());
+        } else {
+            for (int j = 0; j < n_run; j++)
+                memcpy(run_out + j * d_k_bytes, run_in + j * d_n_bytes, d_k_bytes);
+            std::fill(run_corrections, run_corrections + n_run, 0);
+        }
+        i += n_run;
+    }
+
     for (int i = 0; i < n_codewords; i++) {
-        const int corrections = d_codec->decode(in, out);
+        const int corrections = d_corrections[i];
         if (corrections > 0) {
             GR_LOG_DEBUG_LEVEL(1,
                                "frame = {:d}, BCH decoder corrections = {:d}",
@@ -100,19 +150,24 @@ int bch_decoder_bb_impl::general_work(int noutput_items,
                                corrections);
         } else if (corrections == -1) {
             d_frame_error_cnt++;
-            GR_LOG_DEBUG_LEVEL(
-                1,
-                "frame = {:d}, BCH decoder too many bit errors (FER = {:g})",
-                d_frame_cnt,
-                ((double)d_frame_error_cnt / (d_frame_cnt + 1)));
+            if (d_converged[i]) {
+                GR_LOG_DEBUG_LEVEL(
+                    1,
+                    "frame = {:d}, BCH check failed after LDPC convergence (FER = {:g})",
+                    d_frame_cnt,
+                    ((double)d_frame_error_cnt / (d_frame_cnt + 1)));
+            } else {
+                GR_LOG_DEBUG_LEVEL(
+                    1,
+                    "frame = {:d}, BCH decoder too many bit errors (FER = {:g})",
+                    d_frame_cnt,
+                    ((double)d_frame_error_cnt / (d_frame_cnt + 1)));
+            }
         }
         d_frame_cnt++;
-        in += d_n_bytes;
-        out += d_k_bytes;
-        consumed += d_n_bytes;
     }
 
-    consume_each(consumed);
+    consume_each(n_codewords * d_n_bytes);
     return noutput_items;
 }
 
@@ -10,9 +10,10 @@
 #ifndef INCLUDED_DVBS2RX_BCH_DECODER_BB_IMPL_H
 #define INCLUDED_DVBS2RX_BCH_DECODER_BB_IMPL_H
 
-#include "bch.h"
+#include "bch_decoder_pool.h"
 #include <gnuradio/dvbs2rx/bch_decoder_bb.h>
 #include <memory>
+#include <vector>
 
 namespace gr {
 namespace dvbs2rx {
@@ -21,19 +22,25 @@ class bch_decoder_bb_impl : public bch_decoder_bb
 {
 private:
     const int d_debug_level;
+    const dvb_bch_converged_t d_converged_mode;
     unsigned int d_k_bytes; // message length in bytes
     unsigned int d_n_bytes; // codeword length in bytes
-    std::unique_ptr<galois_field<uint32_t>> d_gf;
-    std::unique_ptr<bch_codec<uint32_t, bitset256_t>> d_codec;
+    std::shared_ptr<const dvb_bch_codec_t> d_codec; // shared with other instances
+    std::unique_ptr<bch_decoder_pool> d_pool;
+    std::vector<int> d_corrections;   // number of corrections per decoded codeword
+    std::vector<uint8_t> d_converged; // whether each codeword's LDPC decoding converged
     uint64_t d_frame_cnt;
     uint64_t d_frame_error_cnt;
+    const pmt::pmt_t d_ldpc_status_tag_key = pmt::intern("ldpc_status");
 
 public:
     bch_decoder_bb_impl(dvb_standard_t standard,
                         dvb_framesize_t framesize,
                         dvb_code_rate_t rate,
                         dvb_outputmode_t outputmode,
-                        int debug_level);
+                        int debug_level,
+                        dvb_bch_converged_t converged_mode,
+                        int num_threads);
     ~bch_decoder_bb_impl();
 
     void forecast(int noutput_items, gr_vector_int& ninput_items_required);
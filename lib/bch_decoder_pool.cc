@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "bch_decoder_pool.h"
+#include <algorithm>
+
+namespace gr {
+namespace dvbs2rx {
+
+bch_decoder_pool::bch_decoder_pool(std::shared_ptr<const dvb_bch_codec_t> codec,
+                                   int num_threads)
+    : d_codec(std::move(codec)),
+      d_num_threads(std::max(num_threads, 1)),
+      d_pending(0),
+      d_stop(false)
+{
+    for (int i = 0; i < d_num_threads; i++)
+        d_scratch.push_back(std::make_unique<dvb_bch_codec_t::scratch>(*d_codec));
+
+    // The first scratch belongs to the caller's thread
+    for (int i = 1; i < d_num_threads; i++)
+        d_workers.emplace_back(&bch_decoder_pool::worker, this, d_scratch[i].get());
+}
+
+bch_decoder_pool::~bch_decoder_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_job_cv.notify_all();
+    for (auto& thread : d_workers)
+        thread.join();
+}
+
+void bch_decoder_pool::worker(dvb_bch_codec_t::scratch* scratch)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (true) {
+        d_job_cv.wait(lock, [this] { return d_stop || !d_jobs.empty(); });
+        if (d_stop)
+            return;
+        const bch_job_t job = d_jobs.front();
+        d_jobs.pop_front();
+        lock.unlock();
+        d_codec->decode_batch(
+            job.codewords, job.decoded_msgs, job.n_codewords, job.corrections, *scratch);
+        lock.lock();
+        if (--d_pending == 0)
+            d_done_cv.notify_one();
+    }
+}
+
+void bch_decoder_pool::decode_batch(const uint8_t* codewords,
+                                    uint8_t* decoded_msgs,
+                                    size_t n_codewords,
+                                    int* corrections)
+{
+    const size_t n_chunks = std::min(static_cast<size_t>(d_num_threads), n_codewords);
+    if (n_chunks <= 1) {
+        d_codec->decode_batch(
+            codewords, decoded_msgs, n_codewords, corrections, *d_scratch[0]);
+        return;
+    }
+
+    // Queue all chunks but the first for the workers, and decode the first one here
+    const size_t chunk_size = (n_codewords + n_chunks - 1) / n_chunks;
+    const size_t n_bytes = d_codec->get_n() / 8;
+    const size_t k_bytes = d_codec->get_k() / 8;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        for (size_t start = chunk_size; start < n_codewords; start += chunk_size) {
+            d_jobs.push_back({ codewords + start * n_bytes,
+                               decoded_msgs + start * k_bytes,
+                               std::min(chunk_size, n_codewords - start),
+                               corrections + start });
+            d_pending++;
+        }
+    }
+    d_job_cv.notify_all();
+    d_codec->decode_batch(
+        codewords, decoded_msgs, chunk_size, corrections, *d_scratch[0]);
+
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_done_cv.wait(lock, [this] { return d_pending == 0; });
+}
+
+} // namespace dvbs2rx
+} // namespace gr
@@ -0,0 +1,117 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DVBS2RX_BCH_DECODER_POOL_H
+#define INCLUDED_DVBS2RX_BCH_DECODER_POOL_H
+
+#include "bch_codes.h"
+#include <gnuradio/dvbs2rx/api.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace dvbs2rx {
+
+/**
+ * @brief Pool of threads decoding BCH codewords in parallel.
+ *
+ * Each call to decode_batch() splits the given codewords into contiguous chunks, one
+ * per thread, and returns once all chunks are decoded. The caller's thread decodes the
+ * first chunk, while the worker threads decode the others concurrently. Since each
+ * chunk writes to its own region of the output buffers, the decoded messages and the
+ * numbers of corrections are in the same order as the input codewords.
+ *
+ * All threads share the same (immutable) codec, and each thread has its own working
+ * memory. The decode_batch() function is meant to be called from a single thread, such
+ * as the thread running the GNU Radio block's work function.
+ */
+class DVBS2RX_API bch_decoder_pool
+{
+private:
+    /**
+     * @brief Chunk of codewords to be decoded by a worker thread.
+     */
+    struct bch_job_t {
+        const uint8_t* codewords;
+        uint8_t* decoded_msgs;
+        size_t n_codewords;
+        int* corrections;
+    };
+
+    typedef std::unique_ptr<dvb_bch_codec_t::scratch> scratch_ptr_t;
+    std::shared_ptr<const dvb_bch_codec_t> d_codec; /**< Shared codec */
+    int d_num_threads;                              /**< Number of decoding threads */
+    std::vector<scratch_ptr_t> d_scratch;           /**< Working memory of each thread */
+    std::deque<bch_job_t> d_jobs;                   /**< Chunks waiting for a worker */
+    size_t d_pending;                               /**< Chunks not decoded yet */
+    std::vector<std::thread> d_workers;             /**< Worker threads */
+    std::mutex d_mutex;                             /**< Mutex for the jobs and counter */
+    std::condition_variable d_job_cv;               /**< Signals new jobs to workers */
+    std::condition_variable d_done_cv;              /**< Signals decoded chunks */
+    bool d_stop;                                    /**< Whether the workers must exit */
+
+    void worker(dvb_bch_codec_t::scratch* scratch);
+
+public:
+    /**
+     * @brief Construct a new BCH decoder pool.
+     *
+     * @param codec BCH codec shared by all threads.
+     * @param num_threads Number of decoding threads, including the caller's thread.
+     * When equal to 1 (or lower), the codewords are decoded on the caller's thread
+     * only, and no worker thread is created.
+     */
+    bch_decoder_pool(std::shared_ptr<const dvb_bch_codec_t> codec, int num_threads);
+    ~bch_decoder_pool();
+
+    /**
+     * @brief Get the number of decoding threads.
+     * @return int Number of threads, including the caller's thread.
+     */
+    int num_threads() const { return d_num_threads; }
+
+    /**
+     * @brief Get the working memory of the caller's thread.
+     *
+     * Can be used for other codec operations on the caller's thread (e.g.,
+     * bch_codec::check_batch()) outside of decode_batch() calls.
+     *
+     * @return dvb_bch_codec_t::scratch& Working memory.
+     */
+    dvb_bch_codec_t::scratch& scratch() { return *d_scratch[0]; }
+
+    /**
+     * @brief Decode a batch of codewords using all threads.
+     *
+     * Same as bch_codec::decode_batch(), but with the codewords split across the
+     * threads of the pool.
+     *
+     * @param codewords Pointer to the received codewords with n/8 bytes each, stored
+     * back-to-back.
+     * @param decoded_msgs Pointer to the decoded messages buffer with space for k/8 bytes
+     * per codeword.
+     * @param n_codewords Number of codewords to decode.
+     * @param corrections Pointer to the output array with the number of bit errors
+     * corrected on each codeword (-1 on decoding failure).
+     */
+    void decode_batch(const uint8_t* codewords,
+                      uint8_t* decoded_msgs,
+                      size_t n_codewords,
+                      int* corrections);
+};
+
+} // namespace dvbs2rx
+} // namespace gr
+
+#endif // INCLUDED_DVBS2RX_BCH_DECODER_POOL_H
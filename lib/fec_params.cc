@@ -343,5 +343,25 @@ void get_fec_info(dvb_standard_t standard,
     fec_info.ldpc.k = fec_info.bch.n;
 }
 
+bool get_modcod_fec(uint8_t modcod,
+                    bool short_fecframe,
+                    dvb_framesize_t& framesize,
+                    dvb_code_rate_t& rate)
+{
+    // Code rates of the DVB-S2 MODCODs 1 to 28 (QPSK, 8PSK, 16APSK, and 32APSK)
+    static const dvb_code_rate_t modcod_rates[] = {
+        C1_4, C1_3, C2_5, C1_2, C3_5, C2_3, C3_4, C4_5, C5_6, C8_9, C9_10, // QPSK
+        C3_5, C2_3, C3_4, C5_6, C8_9, C9_10,                               // 8PSK
+        C2_3, C3_4, C4_5, C5_6, C8_9, C9_10,                               // 16APSK
+        C3_4, C4_5, C5_6, C8_9, C9_10                                      // 32APSK
+    };
+    if (modcod < 1 || modcod > MAX_MODCOD)
+        return false;
+    rate = modcod_rates[modcod - 1];
+    framesize = short_fecframe ? FECFRAME_SHORT : FECFRAME_NORMAL;
+    // The 9/10 rate is not defined for short FECFRAMEs
+    return !(short_fecframe && rate == C9_10);
+}
+
 } // namespace dvbs2rx
 } // namespace gr
\ No newline at end of file
@@ -32,11 +32,29 @@ struct fec_info_t {
     ldpc_info_t ldpc;
 };
 
+// Highest DVB-S2 MODCOD with a defined FEC configuration (32APSK 9/10)
+#define MAX_MODCOD 28
+
 void get_fec_info(dvb_standard_t standard,
                   dvb_framesize_t framesize,
                   dvb_code_rate_t rate,
                   fec_info_t& fec_info);
 
+/**
+ * @brief Get the FECFRAME size and code rate of a DVB-S2 MODCOD.
+ *
+ * @param modcod 5-bit MODCOD field from the PLSC.
+ * @param short_fecframe Whether the FECFRAME is short.
+ * @param framesize (dvb_framesize_t&) Resulting FECFRAME size.
+ * @param rate (dvb_code_rate_t&) Resulting code rate.
+ * @return true if the MODCOD is valid for the given FECFRAME size, false otherwise
+ * (e.g., for dummy PLFRAMEs or for the 9/10 rate on short FECFRAMEs).
+ */
+bool get_modcod_fec(uint8_t modcod,
+                    bool short_fecframe,
+                    dvb_framesize_t& framesize,
+                    dvb_code_rate_t& rate);
+
 } // namespace dvbs2rx
 } // namespace gr
 #endif
\ No newline at end of file
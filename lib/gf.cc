@@ -9,6 +9,7 @@
 
 #include "gf.h"
 #include "gf_util.h"
+#include <algorithm>
 #include <cassert>
 
 namespace gr {
@@ -20,8 +21,9 @@ template <typename T>
 galois_field<T>::galois_field(const gf2_poly<T>& prim_poly)
     : m_m(prim_poly.degree()),
       m_two_to_m_minus_one((1 << m_m) - 1),
-      m_table(1 << m_m),              // GF(2^m) has 2^m elements
-      m_table_nonzero((1 << m_m) - 1) // among which 2^m - 1 are non-zero
+      m_table(1 << m_m),                // GF(2^m) has 2^m elements
+      m_antilog(2 * ((1 << m_m) - 1)),  // among which 2^m - 1 are non-zero
+      m_log(1 << m_m, 0)
 {
     // The field elements can be represented with m bits each. However, the minimal
     // polynomials can have degree up to m such that they need a storage of "m + 1" bits
@@ -51,52 +53,32 @@ galois_field<T>::galois_field(const gf2_poly<T>& prim_poly)
         m_table[i + 1] = ((m_table[i] << 1) & m_two_to_m_minus_one) ^
                          ((m_table[i] >> (m_m - 1)) * prim_poly_exc_high_bit);
 
-    // For performance, keep also a table of non-zero elements and use it when the lookup
-    // is by the exponent i of the element alpha^i (i.e., on method get_alpha_i()) instead
-    // of a lookup by index. While alpha^i is stored at position i + 1 in m_table, the
-    // same element is stored in position i in m_table_nonzero. Hence, the exponent i maps
-    // directly to the index at the m_table_nonzero vector, which makes the lookup
-    // slightly faster. This strategy can make a difference when many lookups are
+    // For performance, keep also a table of non-zero elements (the antilog table) and use
+    // it when the lookup is by the exponent i of the element alpha^i (i.e., on method
+    // get_alpha_i()) instead of a lookup by index. While alpha^i is stored at position
+    // i + 1 in m_table, the same element is stored in position i in m_antilog. Hence, the
+    // exponent i maps directly to the index at the m_antilog vector, which makes the
+    // lookup slightly faster. This strategy can make a difference when many lookups are
     // required, as in the polynomial root search (search_roots_in_exp_range() method).
+    // Moreover, the antilog table repeats the non-zero elements twice, so that the sum
+    // (or difference) of two exponents can index it directly with no modulo operation.
+    for (uint32_t i = 0; i < 2 * m_two_to_m_minus_one; i++)
+        m_antilog[i] = m_table[(i % m_two_to_m_minus_one) + 1];
+
+    // Log table (Exponent LUT): map each non-zero element alpha^i to its exponent i. The
+    // entry of the zero element is a dummy, which keeps the branch-free arithmetic
+    // within the bounds of the antilog table.
     for (uint32_t i = 0; i < m_two_to_m_minus_one; i++)
-        m_table_nonzero[i] = m_table[i + 1];
-
-    // Inverse LUT (Exponent LUT): map each non-zero element alpha^i to its exponent i.
-    for (uint32_t i = 0; i < m_two_to_m_minus_one; i++)
-        m_exp_table.insert({ m_table_nonzero[i], i }); // m_table_nonzero[i] = alpha^i
-}
-
-template <typename T>
-T galois_field<T>::multiply(const T& a, const T& b) const
-{
-    if (a == 0 || b == 0)
-        return 0;
-    return get_alpha_i(get_exponent(a) + get_exponent(b));
-}
-
-template <typename T>
-T galois_field<T>::inverse(const T& beta) const
-{
-    // We want "beta^-1" such that "beta * beta^-1 = 1". For that, we use the property
-    // that any GF(2^m) element raised to the power "2^m - 1" is equal to one, i.e.,
-    // "beta^(2^m - 1) = 1". Hence, if beta is alpha^j (the j-th power of the primitive
-    // element), then beta^-1 must be the element alpha^k such that "j + k = 2^m - 1".
-    return get_alpha_i(m_two_to_m_minus_one - get_exponent(beta));
+        m_log[m_antilog[i]] = i; // m_antilog[i] = alpha^i
 }
 
 template <typename T>
 T galois_field<T>::inverse_by_exp(uint32_t i) const
 {
-    // See the comments on inverse() above.
+    // See the comments on inverse().
     return get_alpha_i(m_two_to_m_minus_one - i);
 }
 
-template <typename T>
-T galois_field<T>::divide(const T& a, const T& b) const
-{
-    return multiply(a, inverse(b));
-}
-
 template <typename T>
 std::set<T> galois_field<T>::get_conjugates(const T& beta) const
 {
@@ -203,6 +185,14 @@ void gf2m_poly<T>::set_coef_exponents()
     m_n_nonzero_coef = m_nonzero_coef_idx.size();
 }
 
+template <typename T>
+void gf2m_poly<T>::assign(const T* coefs, size_t n_coefs)
+{
+    m_poly.assign(coefs, coefs + n_coefs);
+    set_degree();
+    set_coef_exponents();
+}
+
 template <typename T>
 gf2m_poly<T> gf2m_poly<T>::operator+(const gf2m_poly<T>& x) const
 {
@@ -290,6 +280,19 @@ template <typename T>
 std::vector<uint32_t> gf2m_poly<T>::search_roots_in_exp_range(uint32_t i_start,
                                                               uint32_t i_end,
                                                               uint32_t max_roots) const
+{
+    std::vector<uint32_t> root_exps;
+    std::vector<uint64_t> workspace;
+    search_roots_in_exp_range(i_start, i_end, max_roots, root_exps, workspace);
+    return root_exps;
+}
+
+template <typename T>
+void gf2m_poly<T>::search_roots_in_exp_range(uint32_t i_start,
+                                             uint32_t i_end,
+                                             uint32_t max_roots,
+                                             std::vector<uint32_t>& root_exps,
+                                             std::vector<uint64_t>& workspace) const
 {
     // Based on eval_by_exp() but optimized for a contiguous range of exponents.
     //
@@ -376,21 +379,34 @@ std::vector<uint32_t> gf2m_poly<T>::search_roots_in_exp_range(uint32_t i_start,
     if (i_start > i_end)
         throw std::runtime_error("Start exponent is greater than end exponent");
 
-    // Step 1
-    std::vector<uint32_t> accum = m_nonzero_coef_exp;
+    // Long ranges (e.g., the Chien search of a BCH decoder) go through the bit-sliced
+    // implementation, while short ranges are not worth its setup cost.
+    const uint64_t n_exps = static_cast<uint64_t>(i_end) - i_start + 1;
+    if (m_degree > 0 && n_exps >= (4 * 64 * 64)) {
+        search_roots_bitsliced<4>(i_start, i_end, max_roots, root_exps, workspace);
+        return;
+    }
+    if (m_degree > 0 && n_exps >= (16 * 64)) {
+        search_roots_bitsliced<1>(i_start, i_end, max_roots, root_exps, workspace);
+        return;
+    }
 
-    // Step 2
+    // Steps 1 and 2, with the accumulator kept on the workspace. The accumulated values
+    // wrap around as 32-bit values, as assumed in the note of step 2.
+    workspace.resize(m_n_nonzero_coef);
+    uint64_t* accum = workspace.data();
     for (size_t j = 0; j < m_n_nonzero_coef; j++) {
-        accum[j] += (i_start - 1) * m_nonzero_coef_idx[j];
+        accum[j] = static_cast<uint32_t>(m_nonzero_coef_exp[j] +
+                                         (i_start - 1) * m_nonzero_coef_idx[j]);
     }
 
     // Step 3
-    std::vector<uint32_t> root_exps;
+    root_exps.clear();
     uint32_t n_found = 0; // number of roots found so far
     for (uint32_t i = i_start; i <= i_end; i++) {
         T res = 0; // evaluation result
         for (size_t j = 0; j < m_n_nonzero_coef; j++) {
-            accum[j] += m_nonzero_coef_idx[j];
+            accum[j] = static_cast<uint32_t>(accum[j] + m_nonzero_coef_idx[j]);
             res ^= m_gf->get_alpha_i(accum[j]);
         }
         if (res == 0) {
@@ -399,8 +415,142 @@ std::vector<uint32_t> gf2m_poly<T>::search_roots_in_exp_range(uint32_t i_start,
                 break;
         }
     }
+}
 
-    return root_exps;
+template <typename T>
+template <int N_WORDS>
+void gf2m_poly<T>::search_roots_bitsliced(uint32_t i_start,
+                                          uint32_t i_end,
+                                          uint32_t max_roots,
+                                          std::vector<uint32_t>& root_exps,
+                                          std::vector<uint64_t>& workspace) const
+{
+    // Bit-sliced Chien search.
+    //
+    // Each GF(2^m) element can be seen as a vector of m bits, where bit r is the
+    // coefficient of alpha^r in the polynomial representation of the element. In the
+    // bit-sliced representation, the r-th bits of L = 64 * N_WORDS elements are packed
+    // together into a "bit plane" of N_WORDS words, so that each lane (bit position) of
+    // the m planes holds a different element. Then, adding the elements of two sets of
+    // L elements takes m * N_WORDS XOR operations, regardless of L.
+    //
+    // The range of exponents is split into L contiguous chunks of n_steps exponents,
+    // one per lane. For each non-zero term "sigma_j x^j" of the polynomial, the search
+    // keeps the term's values "sigma_j (alpha^i)^j" in bit-sliced form, with the
+    // exponent i of each lane starting at the beginning of the lane's chunk. On every
+    // step, the sum of the terms gives the polynomial evaluated for L exponents, and the
+    // lanes where the sum is zero indicate roots. Then, advancing all lanes to the next
+    // exponent (i + 1) means multiplying each term by alpha^j, which is equivalent to j
+    // multiplications by alpha.
+    //
+    // A multiplication by alpha shifts the bits of the element up by one position, such
+    // that the overflowing bit (coefficient of alpha^m) wraps around into the bits of
+    // the primitive polynomial's lower-degree terms, given that alpha^m is equal to the
+    // primitive polynomial without its x^m term. In bit-sliced form, the shift is a
+    // rotation of the m planes, which is done by decrementing the index (offset) of the
+    // plane holding the zero-degree coefficient on a circular buffer of planes. Then,
+    // the wrapped plane (the new zero-degree plane) is XORed into the planes of the
+    // other non-zero terms of alpha^m. Hence, the cost of a multiplication by alpha is
+    // just a few XORs of N_WORDS words for the L lanes.
+    static constexpr int n_lanes = 64 * N_WORDS;
+    const int m = m_gf->get_m();
+    const uint32_t two_to_m_minus_one = (static_cast<uint32_t>(1) << m) - 1;
+    const uint64_t n_exps = static_cast<uint64_t>(i_end) - i_start + 1;
+    const uint32_t n_steps = (n_exps + n_lanes - 1) / n_lanes;
+
+    // Non-zero terms of alpha^m other than the zero-degree term, which the rotation of
+    // planes already handles.
+    const T alpha_m = m_gf->get_alpha_i(m);
+    int taps[sizeof(T) * 8];
+    int n_taps = 0;
+    for (int r = 1; r < m; r++) {
+        if (is_bit_set(alpha_m, r))
+            taps[n_taps++] = r;
+    }
+
+    // The workspace holds the bit planes of each term, followed by the bit planes of the
+    // sum and the plane offsets of each term.
+    const size_t plane_size = m * N_WORDS;
+    workspace.resize((m_n_nonzero_coef + 1) * plane_size + m_n_nonzero_coef);
+    uint64_t* planes = workspace.data();
+    uint64_t* sum = planes + m_n_nonzero_coef * plane_size;
+    uint64_t* offsets = sum + plane_size; // plane of the zero-degree bit
+    std::fill(planes, sum, 0);
+    std::fill(offsets, offsets + m_n_nonzero_coef, 0);
+
+    // Initial bit planes of each term, with lane l starting at "i_start + l * n_steps"
+    for (size_t j = 0; j < m_n_nonzero_coef; j++) {
+        uint32_t exp = (m_nonzero_coef_exp[j] +
+                        static_cast<uint64_t>(m_nonzero_coef_idx[j]) * i_start) %
+                       two_to_m_minus_one;
+        const uint32_t exp_step =
+            (static_cast<uint64_t>(m_nonzero_coef_idx[j]) * n_steps) % two_to_m_minus_one;
+        for (int l = 0; l < n_lanes; l++) {
+            const T val = m_gf->get_alpha_i(exp);
+            uint64_t* lane_word = planes + j * plane_size + (l / 64);
+            for (int r = 0; r < m; r++)
+                lane_word[r * N_WORDS] |= static_cast<uint64_t>(is_bit_set(val, r))
+                                          << (l % 64);
+            exp += exp_step;
+            if (exp >= two_to_m_minus_one)
+                exp -= two_to_m_minus_one;
+        }
+    }
+
+    root_exps.clear();
+    for (uint32_t k = 0; k < n_steps; k++) {
+        std::fill(sum, sum + plane_size, 0);
+        for (size_t j = 0; j < m_n_nonzero_coef; j++) {
+            uint64_t* term = planes + j * plane_size;
+            int offset = offsets[j];
+
+            // Accumulate the term into the sum
+            for (int r = 0; r < m; r++) {
+                const int plane = (offset + r < m) ? offset + r : offset + r - m;
+                for (int w = 0; w < N_WORDS; w++)
+                    sum[r * N_WORDS + w] ^= term[plane * N_WORDS + w];
+            }
+
+            // Multiply by alpha^j for the next step
+            for (uint32_t n_mult = 0; n_mult < m_nonzero_coef_idx[j]; n_mult++) {
+                offset = (offset == 0) ? m - 1 : offset - 1;
+                const uint64_t* wrapped = term + offset * N_WORDS;
+                for (int i_tap = 0; i_tap < n_taps; i_tap++) {
+                    const int r = taps[i_tap];
+                    const int plane = (offset + r < m) ? offset + r : offset + r - m;
+                    for (int w = 0; w < N_WORDS; w++)
+                        term[plane * N_WORDS + w] ^= wrapped[w];
+                }
+            }
+            offsets[j] = offset;
+        }
+
+        // Lanes with a zero sum across all planes are roots
+        for (int w = 0; w < N_WORDS; w++) {
+            uint64_t non_zero = 0;
+            for (int r = 0; r < m; r++)
+                non_zero |= sum[r * N_WORDS + w];
+            if (~non_zero == 0)
+                continue;
+            for (int b = 0; b < 64; b++) {
+                const uint64_t lane = 64 * w + b;
+                const uint64_t i = i_start + lane * n_steps + k;
+                if (!((non_zero >> b) & 1) && i <= i_end)
+                    root_exps.push_back(i);
+            }
+        }
+
+        // A polynomial of degree d has up to d roots, so once d roots are found, the
+        // remaining exponents do not need to be evaluated. Otherwise, when max_roots is
+        // lower than the degree, the search cannot stop early, as the lanes find roots
+        // out of order and the lowest max_roots exponents must be returned.
+        if (root_exps.size() >= max_roots && max_roots >= static_cast<uint32_t>(m_degree))
+            break;
+    }
+
+    std::sort(root_exps.begin(), root_exps.end());
+    if (root_exps.size() > max_roots)
+        root_exps.resize(max_roots);
 }
 
 template <typename T>
@@ -11,8 +11,8 @@
 #define INCLUDED_DVBS2RX_GF_H
 
 #include <gnuradio/dvbs2rx/api.h>
-#include <unordered_map>
 #include <bitset>
+#include <cassert>
 #include <cstdint>
 #include <limits>
 #include <set>
@@ -65,11 +65,11 @@ template <typename T>
 class DVBS2RX_API galois_field
 {
 private:
-    const uint8_t m_m;                           // dimension of the GF(2^m) field
-    const uint32_t m_two_to_m_minus_one;         // shortcut for (2^m - 1)
-    std::vector<T> m_table;                      // field elements
-    std::vector<T> m_table_nonzero;              // non-zero field elements
-    std::unordered_map<T, uint32_t> m_exp_table; // map element alpha^i to its exponent i
+    const uint8_t m_m;                   // dimension of the GF(2^m) field
+    const uint32_t m_two_to_m_minus_one; // shortcut for (2^m - 1)
+    std::vector<T> m_table;              // field elements
+    std::vector<T> m_antilog;            // alpha^i for i from 0 to 2*(2^m - 1) - 1
+    std::vector<uint32_t> m_log;         // map element alpha^i to its exponent i
 
 public:
     /**
@@ -96,7 +96,7 @@ public:
      * zero element cannot be expressed as a power of the primitive element. To access the
      * zero element, use the operator[] instead.
      */
-    T get_alpha_i(uint32_t i) const { return m_table_nonzero[i % m_two_to_m_minus_one]; }
+    T get_alpha_i(uint32_t i) const { return m_antilog[i % m_two_to_m_minus_one]; }
 
     /**
      * @brief Get the exponent i of a given element beta = alpha^i.
@@ -105,9 +105,15 @@ public:
      * @return T Exponent i.
      * @note This function cannot obtain the exponent of the zero (additive identity)
      * element, given the zero element cannot be expressed as a power of the primitive
-     * element alpha. A runtime error exception is raised if beta is the zero element.
+     * element alpha. An out-of-range exception is raised if beta is the zero element or
+     * not an element of the field.
      */
-    uint32_t get_exponent(const T& beta) const { return m_exp_table.at(beta); }
+    uint32_t get_exponent(const T& beta) const
+    {
+        if (!(beta > 0 && beta <= static_cast<T>(m_two_to_m_minus_one)))
+            throw std::out_of_range("Element has no exponent in GF(2^m)");
+        return m_log[beta];
+    }
 
     /**
      * @brief Multiply two elements from GF(2^m).
@@ -115,16 +121,36 @@ public:
      * @param a First multiplicand.
      * @param b Second multiplicand.
      * @return T Product a*b.
+     * @note Branch-free: the sum of the exponents indexes the antilog table directly,
+     * without a modulo operation, and a mask zeroes the result if a or b is zero. The
+     * operands must be elements of the field (checked by assertion only).
      */
-    T multiply(const T& a, const T& b) const;
+    T multiply(const T& a, const T& b) const
+    {
+        assert(static_cast<size_t>(a) < m_log.size() &&
+               static_cast<size_t>(b) < m_log.size());
+        const T mask = -static_cast<T>((a != 0) & (b != 0));
+        return m_antilog[m_log[a] + m_log[b]] & mask;
+    }
 
     /**
      * @brief Get the inverse beta^-1 from a GF(2^m) element beta.
      *
      * @param beta Element to invert.
      * @return T Inverse beta^-1.
+     * @note The zero element has no inverse, and the result is unspecified for it. The
+     * element must be a non-zero element of the field (checked by assertion only).
      */
-    T inverse(const T& beta) const;
+    T inverse(const T& beta) const
+    {
+        assert(beta != 0 && static_cast<size_t>(beta) < m_log.size());
+        // We want "beta^-1" such that "beta * beta^-1 = 1". For that, we use the property
+        // that any GF(2^m) element raised to the power "2^m - 1" is equal to one, i.e.,
+        // "beta^(2^m - 1) = 1". Hence, if beta is alpha^j (the j-th power of the
+        // primitive element), then beta^-1 must be the element alpha^k such that "j + k =
+        // 2^m - 1".
+        return m_antilog[m_two_to_m_minus_one - m_log[beta]];
+    }
 
     /**
      * @brief Get the inverse from a GF(2^m) element alpha^i given by its exponent i.
@@ -140,8 +166,18 @@ public:
      * @param a Dividend.
      * @param b Divisor.
      * @return T Quotient a/b.
+     * @note Branch-free, like multiply(). The result is unspecified for a zero divisor.
+     * The operands must be elements of the field and the divisor must be non-zero
+     * (checked by assertion only).
      */
-    T divide(const T& a, const T& b) const;
+    T divide(const T& a, const T& b) const
+    {
+        assert(b != 0);
+        assert(static_cast<size_t>(a) < m_log.size() &&
+               static_cast<size_t>(b) < m_log.size());
+        const T mask = -static_cast<T>(a != 0);
+        return m_antilog[m_log[a] + m_two_to_m_minus_one - m_log[b]] & mask;
+    }
 
     /**
      * @brief Get the conjugates of element beta.
@@ -378,6 +414,21 @@ private:
      */
     void set_coef_exponents();
 
+    /**
+     * @brief Bit-sliced root search over a range of exponents.
+     *
+     * Implements search_roots_in_exp_range() for 64 * N_WORDS field positions at once.
+     * See the implementation for details.
+     *
+     * @tparam N_WORDS Number of 64-bit words per bit plane.
+     */
+    template <int N_WORDS>
+    void search_roots_bitsliced(uint32_t i_start,
+                                uint32_t i_end,
+                                uint32_t max_roots,
+                                std::vector<uint32_t>& root_exps,
+                                std::vector<uint64_t>& workspace) const;
+
 public:
     /**
      * @brief Construct a new polynomial over GF(2^m).
@@ -408,6 +459,16 @@ public:
         set_coef_exponents();
     };
 
+    /**
+     * @brief Replace the polynomial coefficients.
+     *
+     * @param coefs Pointer to the new polynomial coefficients.
+     * @param n_coefs Number of coefficients.
+     * @note Reuses the memory already allocated by the polynomial object, so a single
+     * object can be recycled across computations with no memory allocations.
+     */
+    void assign(const T* coefs, size_t n_coefs);
+
     /**
      * @brief GF(2^m) polynomial addition.
      *
@@ -487,20 +548,36 @@ public:
      * Instead, it is optimized by leveraging the fact that the evaluation is for a
      * contiguous range of exponents. Hence, when searching for polynomial roots in
      * GF(2^m), it is preferable to use this function instead of manually calling the
-     * eval() or eval_by_exp() functions.
+     * eval() or eval_by_exp() functions. Furthermore, for long ranges, the search
+     * evaluates many elements in parallel, using a bit-sliced representation of GF(2^m)
+     * elements on 64-bit words (a Chien search).
      *
      * @param i_start Exponent of element alpha^i_start at the start of the range.
      * @param i_end Exponent of element alpha^i_end at the end of the range.
      * @param max_roots Maximum number of roots to be returned. When defined, the search
      * is stopped earlier as soon as this number of roots is found.
      * @return std::vector<uint32_t> Vector with the exponents associated with the GF(2^m)
-     * roots found in the range.
+     * roots found in the range, in ascending order. When there are more than max_roots
+     * roots in the range, the max_roots lowest exponents are returned.
      */
     std::vector<uint32_t> search_roots_in_exp_range(
         uint32_t i_start,
         uint32_t i_end,
         uint32_t max_roots = std::numeric_limits<uint32_t>::max()) const;
 
+    /**
+     * @overload
+     * @param root_exps Output vector with the exponents of the roots found in the range.
+     * @param workspace Working memory used by the search, resized as needed.
+     * @note When reusing the same output and workspace vectors across calls, the search
+     * does not allocate memory after the vectors reach the required capacity.
+     */
+    void search_roots_in_exp_range(uint32_t i_start,
+                                   uint32_t i_end,
+                                   uint32_t max_roots,
+                                   std::vector<uint32_t>& root_exps,
+                                   std::vector<uint64_t>& workspace) const;
+
     /**
      * @brief Get the polynomial coefficients.
      *
@@ -11,7 +11,9 @@
 #define INCLUDED_DVBS2RX_GF_UTIL_H
 
 #include "gf.h"
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <stdexcept>
 #include <vector>
 
@@ -274,6 +276,219 @@ gf2_poly_rem(const u8_vector_t& y, const gf2_poly<T>& x, const std::array<T, 256
     return gf2_poly_rem(y.data(), y.size(), x, x_lut);
 }
 
+/**
+ * @brief Build slicing-by-8 LUTs to assist with GF(2) polynomial remainder computation
+ *
+ * Generalizes the LUT from `build_gf2_poly_rem_lut` so that the remainder can be
+ * computed over eight input bytes per iteration instead of one. The result comprises
+ * eight LUTs, one for each byte position within a 64-bit input word. The j-th LUT maps
+ * each byte value v to the remainder of "v(x) * x^(d + 8*j)" divided by x(x), where d is
+ * the degree of x(x). Each remainder occupies n_words 64-bit words, with n_words equal
+ * to ceil(d/64), and is left-aligned (shifted to the most significant bits) within the
+ * words. The left alignment keeps the bits feeding the next lookup at the top of the
+ * most significant word regardless of the degree of x(x).
+ *
+ * @tparam T Type whose bits represent the binary polynomial coefficients.
+ * @param x Divisor polynomial, with degree from 1 to 256.
+ * @return std::vector<uint64_t> Slicing-by-8 LUTs with 8 x 256 x n_words words, where
+ * the word w of the entry for value v on the j-th LUT is at index "(j*256 + v)*n_words
+ * + w" and word 0 is the least significant.
+ */
+template <typename T>
+std::vector<uint64_t> build_gf2_poly_rem_slicing_lut(const gf2_poly<T>& x)
+{
+    const int degree = x.degree();
+    if (degree < 1 || degree > 256)
+        throw std::runtime_error("Failed to compute slicing LUT. Unsupported degree.");
+    const int n_words = (degree + 63) / 64;
+    const int n_bits = n_words * 64;
+
+    // Left-aligned remainder of x^d divided by x(x), i.e., x(x) without its leading term
+    std::vector<uint64_t> x_low(n_words, 0);
+    for (int i = 0; i < degree; i++) {
+        if (is_bit_set(x.get_poly(), i)) {
+            const int bit = i + n_bits - degree;
+            x_low[bit / 64] |= static_cast<uint64_t>(1) << (bit % 64);
+        }
+    }
+
+    // Remainders of x^(d + k) for k from 0 to 63, computed iteratively by multiplying the
+    // preceding remainder by x and reducing the overflowing x^d term, if any.
+    std::vector<uint64_t> basis(64 * n_words);
+    std::copy(x_low.begin(), x_low.end(), basis.begin());
+    for (int k = 1; k < 64; k++) {
+        const uint64_t* prev = basis.data() + (k - 1) * n_words;
+        uint64_t* cur = basis.data() + k * n_words;
+        const bool overflow = prev[n_words - 1] >> 63;
+        for (int w = n_words - 1; w > 0; w--)
+            cur[w] = (prev[w] << 1) | (prev[w - 1] >> 63);
+        cur[0] = prev[0] << 1;
+        if (overflow) {
+            for (int w = 0; w < n_words; w++)
+                cur[w] ^= x_low[w];
+        }
+    }
+
+    std::vector<uint64_t> table(8 * 256 * n_words, 0);
+    for (int j = 0; j < 8; j++) {
+        for (int v = 0; v < 256; v++) {
+            uint64_t* entry = table.data() + (j * 256 + v) * n_words;
+            for (int b = 0; b < 8; b++) {
+                if (!(v & (1 << b)))
+                    continue;
+                const uint64_t* rem = basis.data() + (8 * j + b) * n_words;
+                for (int w = 0; w < n_words; w++)
+                    entry[w] ^= rem[w];
+            }
+        }
+    }
+    return table;
+}
+
+template <int N_WORDS, int N_Y = 1>
+inline void _gf2_poly_rem_sliced(u8_cptr_t y,
+                                 const int y_size,
+                                 const uint64_t* lut,
+                                 uint64_t* out)
+{
+    // Accumulate on a local array, which the compiler can keep in registers, given it
+    // cannot alias the LUT. With multiple dividends (stored back-to-back), the
+    // remainders are computed in lockstep, so that the LUT lookups of independent
+    // dividends can overlap in the pipeline.
+    uint64_t rem[N_Y][N_WORDS] = {};
+
+    // Eight bytes at a time: the input word and the top word of the running remainder
+    // index the eight LUTs, while the remaining words shift up by 64 bits.
+    int i = 0;
+    for (; i + 8 <= y_size; i += 8) {
+        for (int c = 0; c < N_Y; c++) {
+            uint64_t in_word = 0;
+            for (int b = 0; b < 8; b++)
+                in_word = (in_word << 8) | y[c * y_size + i + b];
+            const uint64_t top = rem[c][N_WORDS - 1] ^ in_word;
+            for (int w = N_WORDS - 1; w > 0; w--)
+                rem[c][w] = rem[c][w - 1];
+            rem[c][0] = 0;
+            for (int j = 0; j < 8; j++) {
+                const uint8_t byte = top >> (8 * j);
+                const uint64_t* entry = lut + (j * 256 + byte) * N_WORDS;
+                for (int w = 0; w < N_WORDS; w++)
+                    rem[c][w] ^= entry[w];
+            }
+        }
+    }
+
+    // Remaining bytes one at a time based on the first LUT
+    for (; i < y_size; i++) {
+        for (int c = 0; c < N_Y; c++) {
+            const uint8_t top = (rem[c][N_WORDS - 1] >> 56) ^ y[c * y_size + i];
+            for (int w = N_WORDS - 1; w > 0; w--)
+                rem[c][w] = (rem[c][w] << 8) | (rem[c][w - 1] >> 56);
+            rem[c][0] <<= 8;
+            const uint64_t* entry = lut + top * N_WORDS;
+            for (int w = 0; w < N_WORDS; w++)
+                rem[c][w] ^= entry[w];
+        }
+    }
+
+    for (int c = 0; c < N_Y; c++) {
+        for (int w = 0; w < N_WORDS; w++)
+            out[c * N_WORDS + w] = rem[c][w];
+    }
+}
+
+template <int N_WORDS>
+inline void _gf2_poly_rem_sliced_batch(u8_cptr_t y,
+                                       const int y_size,
+                                       size_t n_y,
+                                       const uint64_t* lut,
+                                       uint64_t* out)
+{
+    size_t i = 0;
+    for (; i + 4 <= n_y; i += 4)
+        _gf2_poly_rem_sliced<N_WORDS, 4>(y + i * y_size, y_size, lut, out + i * N_WORDS);
+    for (; i < n_y; i++)
+        _gf2_poly_rem_sliced<N_WORDS>(y + i * y_size, y_size, lut, out + i * N_WORDS);
+}
+
+/**
+ * @brief Compute the remainder "(y * x^d) % x" using slicing-by-8 LUTs
+ *
+ * Computes the remainder of the dividend polynomial y(x) multiplied by x^d, where d is
+ * the degree of the divisor x(x), in the same way as a CRC computation. The extra x^d
+ * factor allows the input bytes to be fed to the LUTs directly, and it does not change
+ * whether the remainder is zero, since x(x) is not divisible by x for any polynomial of
+ * interest (with a non-zero constant term). Callers can compensate for the factor when
+ * evaluating the remainder, e.g., by multiplying the evaluation at alpha^i by
+ * alpha^(-i*d).
+ *
+ * @param y Dividend GF(2) polynomial given by an array of bytes in network byte order
+ * (big-endian), i.e., with the most significant byte at index 0.
+ * @param y_size Size of the dividend polynomial y in bytes.
+ * @param lut LUTs generated by the `build_gf2_poly_rem_slicing_lut` function for x(x).
+ * @param rem Output buffer for the n_words words of the remainder, left-aligned as in
+ * the LUT entries, with n_words given by "lut.size() / (8 * 256)".
+ */
+inline void gf2_poly_rem_sliced(u8_cptr_t y,
+                                const int y_size,
+                                const std::vector<uint64_t>& lut,
+                                uint64_t* rem)
+{
+    switch (lut.size() / (8 * 256)) {
+    case 1:
+        _gf2_poly_rem_sliced<1>(y, y_size, lut.data(), rem);
+        break;
+    case 2:
+        _gf2_poly_rem_sliced<2>(y, y_size, lut.data(), rem);
+        break;
+    case 3:
+        _gf2_poly_rem_sliced<3>(y, y_size, lut.data(), rem);
+        break;
+    case 4:
+        _gf2_poly_rem_sliced<4>(y, y_size, lut.data(), rem);
+        break;
+    default:
+        throw std::runtime_error("Invalid slicing LUT size");
+    }
+}
+
+/**
+ * @brief Compute the remainders "(y * x^d) % x" of multiple dividends.
+ *
+ * Same as gf2_poly_rem_sliced(), but for n_y dividends of the same size stored
+ * back-to-back. The dividends are processed four at a time in lockstep, which is
+ * considerably faster than computing the remainders one by one.
+ *
+ * @param y Dividend GF(2) polynomials, each given by y_size bytes in network byte order.
+ * @param y_size Size of each dividend polynomial in bytes.
+ * @param n_y Number of dividends.
+ * @param lut LUTs generated by the `build_gf2_poly_rem_slicing_lut` function for x(x).
+ * @param rem Output buffer for the remainders, with n_words words per dividend.
+ */
+inline void gf2_poly_rem_sliced_batch(u8_cptr_t y,
+                                      const int y_size,
+                                      size_t n_y,
+                                      const std::vector<uint64_t>& lut,
+                                      uint64_t* rem)
+{
+    switch (lut.size() / (8 * 256)) {
+    case 1:
+        _gf2_poly_rem_sliced_batch<1>(y, y_size, n_y, lut.data(), rem);
+        break;
+    case 2:
+        _gf2_poly_rem_sliced_batch<2>(y, y_size, n_y, lut.data(), rem);
+        break;
+    case 3:
+        _gf2_poly_rem_sliced_batch<3>(y, y_size, n_y, lut.data(), rem);
+        break;
+    case 4:
+        _gf2_poly_rem_sliced_batch<4>(y, y_size, n_y, lut.data(), rem);
+        break;
+    default:
+        throw std::runtime_error("Invalid slicing LUT size");
+    }
+}
+
 } // namespace dvbs2rx
 } // namespace gr
 
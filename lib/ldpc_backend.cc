@@ -0,0 +1,352 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018,2019,2024 Ahmet Inan, Ron Economos, Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "ldpc_backend.h"
+#include "cpu_features_macros.h"
+#include "ldpc_tables.h"
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#ifdef CPU_FEATURES_ARCH_ARM
+#include "cpuinfo_arm.h"
+using namespace cpu_features;
+#endif
+
+#ifdef CPU_FEATURES_ARCH_X86
+#include "cpuinfo_x86.h"
+using namespace cpu_features;
+#endif
+
+namespace ldpc_neon {
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate);
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len);
+} // namespace ldpc_neon
+
+namespace ldpc_avx512 {
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate);
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len);
+} // namespace ldpc_avx512
+
+namespace ldpc_avx2 {
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate);
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len);
+} // namespace ldpc_avx2
+
+namespace ldpc_sse41 {
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate);
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len);
+} // namespace ldpc_sse41
+
+namespace ldpc_generic {
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn);
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate);
+LDPCDecoderInterface* ldpc_flooding_dec_create(LDPCInterface* ldpc, int num_threads);
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len);
+} // namespace ldpc_generic
+
+namespace gr {
+namespace dvbs2rx {
+
+namespace {
+struct ldpc_code_factory {
+    template <typename TABLE>
+    LDPCInterface* visit()
+    {
+        return new LDPC<TABLE>();
+    }
+};
+
+enum class simd_backend_t { neon, avx512, avx2, sse41, generic };
+
+// SIMD backends supported by the CPU, from the best to the generic one
+std::vector<simd_backend_t> supported_backends()
+{
+    std::vector<simd_backend_t> backends;
+#ifdef CPU_FEATURES_ARCH_ANY_ARM
+#ifdef CPU_FEATURES_ARCH_AARCH64
+    const bool has_neon = true; // always available on aarch64
+#else
+    const ArmFeatures features = GetArmInfo().features;
+    const bool has_neon = features.neon;
+#endif
+    if (has_neon)
+        backends.push_back(simd_backend_t::neon);
+#endif
+#ifdef CPU_FEATURES_ARCH_X86
+    const X86Features features = GetX86Info().features;
+    if (features.avx512bw)
+        backends.push_back(simd_backend_t::avx512);
+    if (features.avx2)
+        backends.push_back(simd_backend_t::avx2);
+    if (features.sse4_1)
+        backends.push_back(simd_backend_t::sse41);
+#endif
+    backends.push_back(simd_backend_t::generic);
+    return backends;
+}
+
+// Best SIMD backend supported by the CPU
+simd_backend_t best_backend() { return supported_backends().front(); }
+
+// Backend name, as given by the impl() function of its decoders
+const char* backend_name(simd_backend_t backend)
+{
+    switch (backend) {
+    case simd_backend_t::neon:
+        return "neon";
+    case simd_backend_t::avx512:
+        return "avx512bw";
+    case simd_backend_t::avx2:
+        return "avx2";
+    case simd_backend_t::sse41:
+        return "sse4_1";
+    default:
+        return "generic";
+    }
+}
+
+// Create a decoder on the given SIMD backend
+template <typename... ARGS>
+std::unique_ptr<LDPCDecoderInterface> create_decoder(simd_backend_t backend,
+                                                     ARGS... args)
+{
+    LDPCDecoderInterface* decoder = nullptr;
+    switch (backend) {
+#ifdef CPU_FEATURES_ARCH_ANY_ARM
+    case simd_backend_t::neon:
+        decoder = ldpc_neon::ldpc_dec_create(args...);
+        break;
+#endif
+#ifdef CPU_FEATURES_ARCH_X86
+    case simd_backend_t::avx512:
+        decoder = ldpc_avx512::ldpc_dec_create(args...);
+        break;
+    case simd_backend_t::avx2:
+        decoder = ldpc_avx2::ldpc_dec_create(args...);
+        break;
+    case simd_backend_t::sse41:
+        decoder = ldpc_sse41::ldpc_dec_create(args...);
+        break;
+#endif
+    default:
+        decoder = ldpc_generic::ldpc_dec_create(args...);
+    }
+    return std::unique_ptr<LDPCDecoderInterface>(decoder);
+}
+
+// Create a decoder with 16-bit lanes on the given SIMD backend
+std::unique_ptr<LDPCDecoderInterface>
+create_decoder16(simd_backend_t backend, std::shared_ptr<const LDPCConnectivity> conn)
+{
+    LDPCDecoderInterface* decoder = nullptr;
+    switch (backend) {
+#ifdef CPU_FEATURES_ARCH_ANY_ARM
+    case simd_backend_t::neon:
+        decoder = ldpc_neon::ldpc_dec16_create(conn);
+        break;
+#endif
+#ifdef CPU_FEATURES_ARCH_X86
+    case simd_backend_t::avx512:
+        decoder = ldpc_avx512::ldpc_dec16_create(conn);
+        break;
+    case simd_backend_t::avx2:
+        decoder = ldpc_avx2::ldpc_dec16_create(conn);
+        break;
+    case simd_backend_t::sse41:
+        decoder = ldpc_sse41::ldpc_dec16_create(conn);
+        break;
+#endif
+    default:
+        decoder = ldpc_generic::ldpc_dec16_create(conn);
+    }
+    return std::unique_ptr<LDPCDecoderInterface>(decoder);
+}
+
+typedef void (*pack_fn_t)(uint8_t*, const int8_t*, int);
+
+pack_fn_t select_packer()
+{
+    switch (best_backend()) {
+#ifdef CPU_FEATURES_ARCH_ANY_ARM
+    case simd_backend_t::neon:
+        return ldpc_neon::pack_hard_decisions;
+#endif
+#ifdef CPU_FEATURES_ARCH_X86
+    case simd_backend_t::avx512:
+        return ldpc_avx512::pack_hard_decisions;
+    case simd_backend_t::avx2:
+        return ldpc_avx2::pack_hard_decisions;
+    case simd_backend_t::sse41:
+        return ldpc_sse41::pack_hard_decisions;
+#endif
+    default:
+        return ldpc_generic::pack_hard_decisions;
+    }
+}
+
+// Process-wide cache of the prepared connectivity, keyed by code configuration. The
+// entries are weak references, so a connectivity lives as long as its decoders.
+typedef std::tuple<dvb_standard_t, dvb_framesize_t, dvb_code_rate_t> ldpc_cache_key_t;
+std::mutex cache_mutex;
+std::map<ldpc_cache_key_t, std::weak_ptr<const LDPCConnectivity>> cache;
+uint64_t cache_hits = 0;
+uint64_t cache_misses = 0;
+} // namespace
+
+std::unique_ptr<LDPCInterface>
+make_ldpc_code(dvb_standard_t standard, dvb_framesize_t framesize, dvb_code_rate_t rate)
+{
+    return std::unique_ptr<LDPCInterface>(
+        visit_ldpc_table(standard, framesize, rate, ldpc_code_factory()));
+}
+
+std::unique_ptr<LDPCDecoderInterface> make_ldpc_decoder(LDPCInterface* ldpc)
+{
+    return create_decoder(best_backend(), std::make_shared<const LDPCConnectivity>(ldpc));
+}
+
+std::unique_ptr<LDPCDecoderInterface>
+make_ldpc_decoder(dvb_standard_t standard,
+                  dvb_framesize_t framesize,
+                  dvb_code_rate_t rate)
+{
+    auto conn = get_ldpc_connectivity(standard, framesize, rate);
+    if (!conn)
+        return nullptr;
+    return create_decoder(best_backend(), conn, standard, framesize, rate);
+}
+
+std::unique_ptr<LDPCDecoderInterface> make_ldpc_decoder(dvb_standard_t standard,
+                                                        dvb_framesize_t framesize,
+                                                        dvb_code_rate_t rate,
+                                                        const std::string& backend)
+{
+    for (simd_backend_t candidate : supported_backends()) {
+        const std::string name = backend_name(candidate);
+        if (backend != name && backend != name + "_int16")
+            continue;
+        auto conn = get_ldpc_connectivity(standard, framesize, rate);
+        if (!conn)
+            return nullptr;
+        if (backend != name)
+            return create_decoder16(candidate, conn);
+        return create_decoder(candidate, conn, standard, framesize, rate);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<LDPCDecoderInterface> make_ldpc_decoder(dvb_standard_t standard,
+                                                        dvb_framesize_t framesize,
+                                                        dvb_code_rate_t rate,
+                                                        dvb_ldpc_precision_t precision)
+{
+    if (precision == LDPC_PRECISION_AUTO)
+        precision = ldpc_auto_precision(standard, framesize, rate);
+    if (precision != LDPC_PRECISION_INT16)
+        return make_ldpc_decoder(standard, framesize, rate);
+    auto conn = get_ldpc_connectivity(standard, framesize, rate);
+    if (!conn)
+        return nullptr;
+    return create_decoder16(best_backend(), conn);
+}
+
+dvb_ldpc_precision_t ldpc_auto_precision(dvb_standard_t standard,
+                                         dvb_framesize_t framesize,
+                                         dvb_code_rate_t rate)
+{
+    auto ldpc = make_ldpc_code(standard, framesize, rate);
+    if (ldpc && 3 * ldpc->data_len() <= ldpc->code_len())
+        return LDPC_PRECISION_INT16;
+    return LDPC_PRECISION_INT8;
+}
+
+std::vector<std::string> get_ldpc_backends()
+{
+    std::vector<std::string> names;
+    for (simd_backend_t backend : supported_backends())
+        names.push_back(backend_name(backend));
+    return names;
+}
+
+std::unique_ptr<LDPCDecoderInterface> make_ldpc_flooding_decoder(LDPCInterface* ldpc,
+                                                                 int num_threads)
+{
+    return std::unique_ptr<LDPCDecoderInterface>(
+        ldpc_generic::ldpc_flooding_dec_create(ldpc, num_threads));
+}
+
+void ldpc_pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len)
+{
+    static const pack_fn_t packer = select_packer();
+    packer(bytes, soft, len);
+}
+
+std::shared_ptr<const LDPCConnectivity> get_ldpc_connectivity(dvb_standard_t standard,
+                                                              dvb_framesize_t framesize,
+                                                              dvb_code_rate_t rate)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    const ldpc_cache_key_t key(standard, framesize, rate);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        if (auto conn = it->second.lock()) {
+            cache_hits++;
+            return conn;
+        }
+    }
+    auto ldpc = make_ldpc_code(standard, framesize, rate);
+    if (!ldpc)
+        return nullptr;
+    auto conn = std::make_shared<const LDPCConnectivity>(ldpc.get());
+    cache[key] = conn;
+    cache_misses++;
+    return conn;
+}
+
+ldpc_cache_stats_t get_ldpc_cache_stats()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    ldpc_cache_stats_t stats = { cache_hits, cache_misses, 0, 0 };
+    for (const auto& entry : cache) {
+        if (auto conn = entry.second.lock()) {
+            stats.entries++;
+            stats.bytes += conn->size();
+        }
+    }
+    return stats;
+}
+
+} // namespace dvbs2rx
+} // namespace gr
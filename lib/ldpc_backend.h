@@ -0,0 +1,214 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DVBS2RX_LDPC_BACKEND_H
+#define INCLUDED_DVBS2RX_LDPC_BACKEND_H
+
+#include "ldpc_decoder/connectivity.hh"
+#include "ldpc_decoder/decoder_interface.hh"
+#include "ldpc_decoder/ldpc.hh"
+#include <gnuradio/dvbs2rx/api.h>
+#include <gnuradio/dvbs2rx/dvb_config.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace dvbs2rx {
+
+/**
+ * @brief Construct the LDPC code definition for a given FEC configuration.
+ *
+ * @param standard DVB standard (DVB-S2, DVB-S2X, or DVB-T2).
+ * @param framesize FECFRAME size.
+ * @param rate LDPC code rate.
+ * @return std::unique_ptr<LDPCInterface> LDPC code object, or nullptr if the given
+ * combination of standard, frame size, and code rate is not supported.
+ */
+DVBS2RX_API std::unique_ptr<LDPCInterface>
+make_ldpc_code(dvb_standard_t standard, dvb_framesize_t framesize, dvb_code_rate_t rate);
+
+/**
+ * @brief Construct an LDPC decoder for the given code on the best SIMD backend.
+ *
+ * Selects the SIMD implementation (AVX-512BW, AVX2, SSE4.1, NEON, or generic) at
+ * runtime based on the features supported by the CPU. The returned object owns all of
+ * its decoding state, so multiple decoders (e.g., one per block instance) can coexist
+ * in the same process and run concurrently on separate threads.
+ *
+ * @param ldpc LDPC code definition. The decoder keeps no reference to it after
+ * construction, and its connectivity is prepared specifically for the returned
+ * decoder, without going through the process-wide cache.
+ * @return std::unique_ptr<LDPCDecoderInterface> LDPC decoder instance.
+ */
+DVBS2RX_API std::unique_ptr<LDPCDecoderInterface> make_ldpc_decoder(LDPCInterface* ldpc);
+
+/**
+ * @brief Construct an LDPC decoder specialized for the parity bit table of a code.
+ *
+ * Equivalent to make_ldpc_decoder(LDPCInterface*), except that the returned decoder is
+ * instantiated for the code's table, with the check node degrees known at compile
+ * time. The decoded results are identical, while the check node processing can be
+ * unrolled by the compiler. When the library is built without the table-specialized
+ * decoders (LDPC_TABLE_DECODERS option), the generic decoder is returned instead.
+ *
+ * The decoder's connectivity is obtained through get_ldpc_connectivity(), so that all
+ * decoders of the same code share a single copy.
+ *
+ * @param standard DVB standard (DVB-S2, DVB-S2X, or DVB-T2).
+ * @param framesize FECFRAME size.
+ * @param rate LDPC code rate.
+ * @return std::unique_ptr<LDPCDecoderInterface> LDPC decoder instance, or nullptr if
+ * the code configuration is not supported.
+ */
+DVBS2RX_API std::unique_ptr<LDPCDecoderInterface>
+make_ldpc_decoder(dvb_standard_t standard,
+                  dvb_framesize_t framesize,
+                  dvb_code_rate_t rate);
+
+/**
+ * @brief Construct a table-specialized LDPC decoder on a given SIMD backend.
+ *
+ * Same as make_ldpc_decoder(dvb_standard_t, dvb_framesize_t, dvb_code_rate_t), but
+ * on the given backend instead of the best one supported by the CPU, e.g., to compare
+ * the backends against each other.
+ *
+ * @param standard DVB standard (DVB-S2, DVB-S2X, or DVB-T2).
+ * @param framesize FECFRAME size.
+ * @param rate LDPC code rate.
+ * @param backend Backend name, as listed by get_ldpc_backends(), optionally followed by
+ * the "_int16" suffix for the 16-bit decoder of the backend (see
+ * make_ldpc_decoder(dvb_standard_t, dvb_framesize_t, dvb_code_rate_t,
+ * dvb_ldpc_precision_t)).
+ * @return std::unique_ptr<LDPCDecoderInterface> LDPC decoder instance, or nullptr if
+ * the code configuration or the backend is not supported.
+ */
+DVBS2RX_API std::unique_ptr<LDPCDecoderInterface>
+make_ldpc_decoder(dvb_standard_t standard,
+                  dvb_framesize_t framesize,
+                  dvb_code_rate_t rate,
+                  const std::string& backend);
+
+/**
+ * @brief Construct an LDPC decoder with a given precision on the best SIMD backend.
+ *
+ * With 8-bit precision, equivalent to
+ * make_ldpc_decoder(dvb_standard_t, dvb_framesize_t, dvb_code_rate_t). With 16-bit
+ * precision, the decoder holds the messages of each codeword in 16-bit lanes, with
+ * the 8-bit input LLRs scaled up to leave room for a fraction of the LLR unit. It
+ * decodes half as many codewords in parallel, but converges in fewer iterations and
+ * at a lower SNR on the low-rate codes, whose LLRs at the operating SNR take only a
+ * few small integer values. Its impl() name carries the "_int16" suffix. The 16-bit
+ * decoders are not specialized for the code tables.
+ *
+ * @param standard DVB standard (DVB-S2, DVB-S2X, or DVB-T2).
+ * @param framesize FECFRAME size.
+ * @param rate LDPC code rate.
+ * @param precision Decoder precision, or LDPC_PRECISION_AUTO for the precision
+ * returned by ldpc_auto_precision().
+ * @return std::unique_ptr<LDPCDecoderInterface> LDPC decoder instance, or nullptr if
+ * the code configuration is not supported.
+ */
+DVBS2RX_API std::unique_ptr<LDPCDecoderInterface>
+make_ldpc_decoder(dvb_standard_t standard,
+                  dvb_framesize_t framesize,
+                  dvb_code_rate_t rate,
+                  dvb_ldpc_precision_t precision);
+
+/**
+ * @brief Get the LDPC decoder precision suited to a code.
+ *
+ * Selects the 16-bit precision for the codes with rate up to 1/3, which include the
+ * DVB-S2X VL-SNR codes, and the 8-bit precision otherwise.
+ *
+ * @param standard DVB standard (DVB-S2, DVB-S2X, or DVB-T2).
+ * @param framesize FECFRAME size.
+ * @param rate LDPC code rate.
+ * @return dvb_ldpc_precision_t LDPC_PRECISION_INT16 or LDPC_PRECISION_INT8.
+ */
+DVBS2RX_API dvb_ldpc_precision_t ldpc_auto_precision(dvb_standard_t standard,
+                                                     dvb_framesize_t framesize,
+                                                     dvb_code_rate_t rate);
+
+/**
+ * @brief Get the SIMD backends of the LDPC decoder supported by the CPU.
+ * @return std::vector<std::string> Backend names (e.g., "avx2" or "generic"), as
+ * returned by LDPCDecoderInterface::impl(), from the best to the generic one.
+ */
+DVBS2RX_API std::vector<std::string> get_ldpc_backends();
+
+/**
+ * @brief Construct an LDPC decoder with the flooding schedule for a single codeword.
+ *
+ * The returned decoder processes one codeword at a time (its simd_size() is 1), with
+ * the bit node and check node updates of each iteration split across the given
+ * number of threads, the caller's thread included. It trades the throughput of the
+ * SIMD batches for the latency of each codeword.
+ *
+ * @param ldpc LDPC code definition. The decoder keeps no reference to it after
+ * construction.
+ * @param num_threads Number of threads decoding each codeword.
+ * @return std::unique_ptr<LDPCDecoderInterface> LDPC decoder instance.
+ */
+DVBS2RX_API std::unique_ptr<LDPCDecoderInterface>
+make_ldpc_flooding_decoder(LDPCInterface* ldpc, int num_threads);
+
+/**
+ * @brief Pack the hard decisions of soft LDPC values into bytes.
+ *
+ * Each group of eight soft values (LLRs) produces one output byte, MSB first, with a
+ * bit equal to 1 for negative values. The packing uses the vector instructions of the
+ * best SIMD backend supported by the CPU (movemask on x86 and narrowing shifts on
+ * NEON), with a scalar fallback otherwise.
+ *
+ * @param bytes Output buffer with room for len / 8 bytes.
+ * @param soft Soft values to pack.
+ * @param len Number of soft values, which must be a multiple of 8.
+ */
+DVBS2RX_API void ldpc_pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len);
+
+/**
+ * @brief Statistics of the process-wide LDPC connectivity cache.
+ */
+struct ldpc_cache_stats_t {
+    uint64_t hits;   /**< Lookups served by an already prepared connectivity */
+    uint64_t misses; /**< Lookups that prepared a new connectivity */
+    size_t entries;  /**< Number of connectivity structures currently in use */
+    size_t bytes;    /**< Memory held by the connectivity structures in use */
+};
+
+/**
+ * @brief Get the prepared LDPC connectivity of a code from the process-wide cache.
+ *
+ * The connectivity (the bit node positions of each check node, reordered for the
+ * layered decoder) is immutable and shared by all decoders of the same code, across
+ * block instances and threads. The cache holds no ownership: each connectivity is
+ * prepared on the first lookup and released once the last decoder using it is
+ * destroyed. This function is thread-safe.
+ *
+ * @param standard DVB standard (DVB-S2, DVB-S2X, or DVB-T2).
+ * @param framesize FECFRAME size.
+ * @param rate LDPC code rate.
+ * @return std::shared_ptr<const LDPCConnectivity> Shared connectivity, or nullptr if
+ * the code configuration is not supported.
+ */
+DVBS2RX_API std::shared_ptr<const LDPCConnectivity> get_ldpc_connectivity(
+    dvb_standard_t standard, dvb_framesize_t framesize, dvb_code_rate_t rate);
+
+/**
+ * @brief Get the hit and miss counts of the process-wide LDPC connectivity cache.
+ * @return ldpc_cache_stats_t Cache statistics.
+ */
+DVBS2RX_API ldpc_cache_stats_t get_ldpc_cache_stats();
+
+} // namespace dvbs2rx
+} // namespace gr
+
+#endif // INCLUDED_DVBS2RX_LDPC_BACKEND_H
@@ -206,6 +206,73 @@ struct OffsetMinSumAlgorithm<SIMD<int8_t, WIDTH>, UPDATE, FACTOR> {
     }
 };
 
+// Same as above with 16-bit lanes, for the codes operating at very low SNR. There,
+// the input LLRs take only a few small integer values, and an offset of one LLR unit
+// (the smallest possible with 8-bit lanes) discards most of the information in the
+// check node messages. The 8-bit input LLRs are scaled up by 2^SHIFT when loaded into
+// the lanes (see LDPCDecoder), and the offset FACTOR / 2 applies to the scaled values,
+// such that it can be a fraction of the input LLR unit. The message clamping still
+// applies in input LLR units, as in the 8-bit version.
+template <int WIDTH, typename UPDATE, int FACTOR>
+struct OffsetMinSumAlgorithm<SIMD<int16_t, WIDTH>, UPDATE, FACTOR> {
+    typedef int16_t VALUE;
+    typedef SIMD<VALUE, WIDTH> TYPE;
+    static const int SHIFT = 3;
+    static TYPE zero() { return vzero<TYPE>(); }
+    static TYPE one() { return vdup<TYPE>(1); }
+    static TYPE sign(TYPE a, TYPE b) { return vsign(a, b); }
+    static TYPE eor(TYPE a, TYPE b)
+    {
+        return vreinterpret<TYPE>(veor(vmask(a), vmask(b)));
+    }
+    static TYPE orr(TYPE a, TYPE b)
+    {
+        return vreinterpret<TYPE>(vorr(vmask(a), vmask(b)));
+    }
+    static TYPE other(TYPE a, TYPE b, TYPE c)
+    {
+        return vreinterpret<TYPE>(vbsl(vceq(a, b), vmask(c), vmask(b)));
+    }
+    static void finalp(TYPE* links, int cnt)
+    {
+        auto beta = vunsigned(vdup<TYPE>(std::nearbyint(0.5 * FACTOR)));
+        TYPE mags[cnt];
+        for (int i = 0; i < cnt; ++i)
+            mags[i] = vsigned(vqsub(vunsigned(vqabs(links[i])), beta));
+
+        TYPE mins[2];
+        mins[0] = vmin(mags[0], mags[1]);
+        mins[1] = vmax(mags[0], mags[1]);
+        for (int i = 2; i < cnt; ++i) {
+            mins[1] = vmin(mins[1], vmax(mins[0], mags[i]));
+            mins[0] = vmin(mins[0], mags[i]);
+        }
+
+        TYPE signs = links[0];
+        for (int i = 1; i < cnt; ++i)
+            signs = eor(signs, links[i]);
+
+        for (int i = 0; i < cnt; ++i)
+            links[i] = sign(other(mags[i], mins[0], mins[1]),
+                            orr(eor(signs, links[i]), vdup<TYPE>(32767)));
+    }
+    static TYPE add(TYPE a, TYPE b) { return vqadd(a, b); }
+    static TYPE sub(TYPE a, TYPE b) { return vqsub(a, b); }
+    static bool bad(TYPE v, int blocks)
+    {
+        auto tmp = vcgtz(v);
+        for (int i = 0; i < blocks; ++i)
+            if (!tmp.v[i])
+                return true;
+        return false;
+    }
+    static void update(TYPE* a, TYPE b)
+    {
+        UPDATE::update(
+            a, vmin(vmax(b, vdup<TYPE>(-(32 << SHIFT))), vdup<TYPE>(31 << SHIFT)));
+    }
+};
+
 
 template <typename VALUE, int WIDTH, typename UPDATE, int FACTOR>
 struct MinSumCAlgorithm<SIMD<VALUE, WIDTH>, UPDATE, FACTOR> {
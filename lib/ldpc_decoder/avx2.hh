@@ -983,4 +983,88 @@ inline SIMD<int64_t, 4> vmax(SIMD<int64_t, 4> a, SIMD<int64_t, 4> b)
     return tmp;
 }
 
+/*
+ * Block transposes between codewords and SIMD lanes. The byte interleaving
+ * instructions operate independently on each 128-bit lane, so each 256-bit register
+ * holds the rows of two 16x16 tiles: one covering codewords 0 to 15, the other
+ * codewords 16 to 31. Four rounds of interleaving between rows i and i + 8 transpose
+ * both tiles at once, after which each register holds a full vector of 32 lanes.
+ */
+static inline void transpose_16x16x2(__m256i* r)
+{
+    for (int round = 0; round < 4; ++round) {
+        __m256i t[16];
+        for (int i = 0; i < 8; ++i) {
+            t[2 * i] = _mm256_unpacklo_epi8(r[i], r[i + 8]);
+            t[2 * i + 1] = _mm256_unpackhi_epi8(r[i], r[i + 8]);
+        }
+        for (int i = 0; i < 16; ++i)
+            r[i] = t[i];
+    }
+}
+
+template <>
+inline void vload_transposed(SIMD<int8_t, 32>* data, const int8_t* const* rows, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m256i r[16];
+        for (int i = 0; i < 16; ++i) {
+            __m128i lo = _mm_loadu_si128((const __m128i*)(rows[i] + j));
+            __m128i hi = _mm_loadu_si128((const __m128i*)(rows[i + 16] + j));
+            r[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        }
+        transpose_16x16x2(r);
+        for (int i = 0; i < 16; ++i)
+            data[j + i].m = r[i];
+    }
+    for (int n = 0; n < 32; ++n)
+        for (int k = j; k < len; ++k)
+            data[k].v[n] = rows[n][k];
+}
+
+template <>
+inline void vstore_transposed(int8_t* const* rows, const SIMD<int8_t, 32>* data, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m256i r[16];
+        for (int i = 0; i < 16; ++i)
+            r[i] = data[j + i].m;
+        transpose_16x16x2(r);
+        for (int i = 0; i < 16; ++i) {
+            _mm_storeu_si128((__m128i*)(rows[i] + j),
+                             _mm256_castsi256_si128(r[i]));
+            _mm_storeu_si128((__m128i*)(rows[i + 16] + j),
+                             _mm256_extracti128_si256(r[i], 1));
+        }
+    }
+    for (int n = 0; n < 32; ++n)
+        for (int k = j; k < len; ++k)
+            rows[n][k] = data[k].v[n];
+}
+
+template <>
+inline void vpack_signs<int8_t, 32>(uint8_t* bytes, const int8_t* soft, int len)
+{
+    // Reverse each group of eight bytes so that movemask places the first soft value
+    // of the group on the MSB of the output byte.
+    const __m256i rev = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10,
+                                         9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12,
+                                         11, 10, 9, 8);
+    int j = 0;
+    for (; j + 32 <= len; j += 32) {
+        __m256i a =
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(soft + j)), rev);
+        uint32_t mask = _mm256_movemask_epi8(a);
+        memcpy(bytes + j / 8, &mask, sizeof(mask));
+    }
+    for (; j < len; j += 8) {
+        uint8_t byte = 0;
+        for (int k = 0; k < 8; ++k)
+            byte = (byte << 1) | (soft[j + k] < 0);
+        bytes[j / 8] = byte;
+    }
+}
+
 #endif
@@ -0,0 +1,352 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef AVX512_HH
+#define AVX512_HH
+
+#include <immintrin.h>
+
+/*
+ * AVX-512BW specializations for the 8-bit SIMD types used by the int8 LDPC
+ * decoder. The comparisons produce mask registers on AVX-512, which are
+ * expanded back to vectors (all ones or all zeros per lane) to preserve the
+ * semantics of the other backends.
+ */
+
+template <>
+union SIMD<int8_t, 64> {
+    static const int SIZE = 64;
+    typedef int8_t value_type;
+    typedef uint8_t uint_type;
+    __m512i m;
+    value_type v[SIZE];
+    uint_type u[SIZE];
+};
+
+template <>
+union SIMD<uint8_t, 64> {
+    static const int SIZE = 64;
+    typedef uint8_t value_type;
+    typedef uint8_t uint_type;
+    __m512i m;
+    value_type v[SIZE];
+    uint_type u[SIZE];
+};
+
+template <>
+inline SIMD<uint8_t, 64> vreinterpret(SIMD<int8_t, 64> a)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = a.m;
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vreinterpret(SIMD<uint8_t, 64> a)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = a.m;
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vdup<SIMD<int8_t, 64>>(int8_t a)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_set1_epi8(a);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vdup<SIMD<uint8_t, 64>>(uint8_t a)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_set1_epi8(a);
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vzero()
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_setzero_si512();
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vzero()
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_setzero_si512();
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vadd(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_add_epi8(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vqadd(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_adds_epi8(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vsub(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_sub_epi8(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vqsub(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_subs_epi8(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vqsub(SIMD<uint8_t, 64> a, SIMD<uint8_t, 64> b)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_subs_epu8(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vabs(SIMD<int8_t, 64> a)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_abs_epi8(a.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vqabs(SIMD<int8_t, 64> a)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_abs_epi8(_mm512_max_epi8(a.m, _mm512_set1_epi8(-INT8_MAX)));
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vsign(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    // There is no 512-bit equivalent of _mm256_sign_epi8. Instead, zero the lanes
+    // where b is zero and negate the lanes where b is negative.
+    SIMD<int8_t, 64> tmp;
+    __mmask64 nonzero = _mm512_test_epi8_mask(b.m, b.m);
+    __mmask64 negative = _mm512_movepi8_mask(b.m);
+    tmp.m = _mm512_mask_sub_epi8(
+        _mm512_maskz_mov_epi8(nonzero, a.m), negative, _mm512_setzero_si512(), a.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vorr(SIMD<uint8_t, 64> a, SIMD<uint8_t, 64> b)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_or_si512(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vand(SIMD<uint8_t, 64> a, SIMD<uint8_t, 64> b)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_and_si512(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> veor(SIMD<uint8_t, 64> a, SIMD<uint8_t, 64> b)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_xor_si512(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vbic(SIMD<uint8_t, 64> a, SIMD<uint8_t, 64> b)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_andnot_si512(b.m, a.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64>
+vbsl(SIMD<uint8_t, 64> a, SIMD<uint8_t, 64> b, SIMD<uint8_t, 64> c)
+{
+    // Bitwise select (a ? b : c) through a single ternary logic instruction
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_ternarylogic_epi32(a.m, b.m, c.m, 0xca);
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vceqz(SIMD<int8_t, 64> a)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_movm_epi8(_mm512_testn_epi8_mask(a.m, a.m));
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vceq(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_movm_epi8(_mm512_cmpeq_epi8_mask(a.m, b.m));
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vcgt(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_movm_epi8(_mm512_cmpgt_epi8_mask(a.m, b.m));
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vcgtz(SIMD<int8_t, 64> a)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_movm_epi8(_mm512_cmpgt_epi8_mask(a.m, _mm512_setzero_si512()));
+    return tmp;
+}
+
+template <>
+inline SIMD<uint8_t, 64> vcltz(SIMD<int8_t, 64> a)
+{
+    SIMD<uint8_t, 64> tmp;
+    tmp.m = _mm512_movm_epi8(_mm512_movepi8_mask(a.m));
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vmin(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_min_epi8(a.m, b.m);
+    return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 64> vmax(SIMD<int8_t, 64> a, SIMD<int8_t, 64> b)
+{
+    SIMD<int8_t, 64> tmp;
+    tmp.m = _mm512_max_epi8(a.m, b.m);
+    return tmp;
+}
+
+/*
+ * Block transposes between codewords and SIMD lanes. As with AVX2, the byte
+ * interleaving instructions operate on each 128-bit lane independently, so each
+ * register holds the rows of four 16x16 tiles, one per group of 16 codewords.
+ */
+static inline void transpose_16x16x4(__m512i* r)
+{
+    for (int round = 0; round < 4; ++round) {
+        __m512i t[16];
+        for (int i = 0; i < 8; ++i) {
+            t[2 * i] = _mm512_unpacklo_epi8(r[i], r[i + 8]);
+            t[2 * i + 1] = _mm512_unpackhi_epi8(r[i], r[i + 8]);
+        }
+        for (int i = 0; i < 16; ++i)
+            r[i] = t[i];
+    }
+}
+
+template <>
+inline void vload_transposed(SIMD<int8_t, 64>* data, const int8_t* const* rows, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m512i r[16];
+        for (int i = 0; i < 16; ++i) {
+            r[i] = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)(rows[i] + j)));
+            r[i] = _mm512_inserti32x4(
+                r[i], _mm_loadu_si128((const __m128i*)(rows[i + 16] + j)), 1);
+            r[i] = _mm512_inserti32x4(
+                r[i], _mm_loadu_si128((const __m128i*)(rows[i + 32] + j)), 2);
+            r[i] = _mm512_inserti32x4(
+                r[i], _mm_loadu_si128((const __m128i*)(rows[i + 48] + j)), 3);
+        }
+        transpose_16x16x4(r);
+        for (int i = 0; i < 16; ++i)
+            data[j + i].m = r[i];
+    }
+    for (int n = 0; n < 64; ++n)
+        for (int k = j; k < len; ++k)
+            data[k].v[n] = rows[n][k];
+}
+
+template <>
+inline void vstore_transposed(int8_t* const* rows, const SIMD<int8_t, 64>* data, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m512i r[16];
+        for (int i = 0; i < 16; ++i)
+            r[i] = data[j + i].m;
+        transpose_16x16x4(r);
+        // Store the four 128-bit quarters through memory rather than extracting them
+        // with intrinsics, which trigger (spurious) -Wmaybe-uninitialized warnings.
+        alignas(64) int8_t quarters[64];
+        for (int i = 0; i < 16; ++i) {
+            _mm512_store_si512((__m512i*)quarters, r[i]);
+            memcpy(rows[i] + j, quarters, 16);
+            memcpy(rows[i + 16] + j, quarters + 16, 16);
+            memcpy(rows[i + 32] + j, quarters + 32, 16);
+            memcpy(rows[i + 48] + j, quarters + 48, 16);
+        }
+    }
+    for (int n = 0; n < 64; ++n)
+        for (int k = j; k < len; ++k)
+            rows[n][k] = data[k].v[n];
+}
+
+template <>
+inline void vpack_signs<int8_t, 64>(uint8_t* bytes, const int8_t* soft, int len)
+{
+    // Reverse each group of eight bytes so that movepi8_mask places the first soft
+    // value of the group on the MSB of the output byte.
+    const __m512i rev = _mm512_set_epi64(0x08090a0b0c0d0e0f,
+                                         0x0001020304050607,
+                                         0x08090a0b0c0d0e0f,
+                                         0x0001020304050607,
+                                         0x08090a0b0c0d0e0f,
+                                         0x0001020304050607,
+                                         0x08090a0b0c0d0e0f,
+                                         0x0001020304050607);
+    int j = 0;
+    for (; j + 64 <= len; j += 64) {
+        __m512i a =
+            _mm512_shuffle_epi8(_mm512_loadu_si512((const __m512i*)(soft + j)), rev);
+        uint64_t mask = _mm512_movepi8_mask(a);
+        memcpy(bytes + j / 8, &mask, sizeof(mask));
+    }
+    for (; j < len; j += 8) {
+        uint8_t byte = 0;
+        for (int k = 0; k < 8; ++k)
+            byte = (byte << 1) | (soft[j + k] < 0);
+        bytes[j / 8] = byte;
+    }
+}
+
+#endif
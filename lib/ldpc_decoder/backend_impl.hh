@@ -0,0 +1,126 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef BACKEND_IMPL_HH
+#define BACKEND_IMPL_HH
+
+#include "../ldpc_tables.h"
+#include "algorithms.hh"
+#include "decoder_interface.hh"
+#include "layered_decoder.hh"
+#include <cstdlib>
+
+/*
+ * Implementation shared by the SIMD backends (AVX-512, AVX2, SSE4.1, NEON, and generic).
+ *
+ * Each backend is described by a traits type providing the 8-bit and 16-bit SIMD types
+ * (simd_type and simd16_type) and the backend names (name and name16). Each backend
+ * then defines its entry points (see ldpc_backend.cc) on top of LDPCBackend<BACKEND>.
+ */
+
+#define FACTOR 2
+#define FACTOR16 4 // 1/4 of the input LLR unit (see OffsetMinSumAlgorithm)
+
+template <typename BACKEND>
+struct LDPCBackend {
+    typedef typename BACKEND::simd_type simd_type;
+    typedef NormalUpdate<simd_type> update_type;
+    typedef OffsetMinSumAlgorithm<simd_type, update_type, FACTOR> algorithm_type;
+
+    // 16-bit lanes, for the codes operating at very low SNR
+    typedef typename BACKEND::simd16_type simd16_type;
+    typedef NormalUpdate<simd16_type> update16_type;
+    typedef OffsetMinSumAlgorithm<simd16_type, update16_type, FACTOR16> algorithm16_type;
+
+    template <typename TABLE = void,
+              typename TYPE = simd_type,
+              typename ALG = algorithm_type>
+    class Decoder : public LDPCDecoderInterface
+    {
+        LDPCDecoder<TYPE, ALG, TABLE> decoder;
+        void* buffer;
+
+    public:
+        Decoder(std::shared_ptr<const LDPCConnectivity> conn)
+        {
+            buffer = aligned_alloc(sizeof(TYPE), sizeof(TYPE) * conn->N);
+            decoder.init(std::move(conn));
+        }
+        const char* impl()
+        {
+            return sizeof(typename TYPE::value_type) > 1 ? BACKEND::name16
+                                                         : BACKEND::name;
+        }
+        int simd_size() { return TYPE::SIZE; }
+        int decode(int8_t* code, int trials) { return decoder(buffer, code, trials); }
+        int decode(const int8_t* const* frames, int trials)
+        {
+            return decoder(buffer, frames, trials);
+        }
+        int decode(const int8_t* const* frames, int* results, int trials)
+        {
+            return decoder(buffer, frames, results, trials);
+        }
+        void store(int8_t* code) { decoder.store(buffer, code); }
+        void pack(uint8_t* bytes, int bits) { decoder.pack(buffer, bytes, bits); }
+        int decode_rolling(int8_t* code, int n_frames, int* results, int trials)
+        {
+            return decoder.rolling(buffer, code, n_frames, results, trials);
+        }
+        int decode_rolling(const int8_t* const* frames,
+                           int8_t* code,
+                           int n_frames,
+                           int* results,
+                           int trials)
+        {
+            return decoder.rolling(buffer, frames, code, n_frames, results, trials);
+        }
+        void set_check_period(int period) { decoder.set_check_period(period); }
+        ~Decoder() { free(buffer); }
+    };
+
+    struct DecoderFactory {
+        std::shared_ptr<const LDPCConnectivity> conn;
+        template <typename TABLE>
+        LDPCDecoderInterface* visit()
+        {
+#ifdef LDPC_TABLE_DECODERS
+            return new Decoder<TABLE>(conn);
+#else
+            return new Decoder<>(conn);
+#endif
+        }
+    };
+
+    static LDPCDecoderInterface* create(std::shared_ptr<const LDPCConnectivity> conn)
+    {
+        return new Decoder<>(std::move(conn));
+    }
+
+    static LDPCDecoderInterface* create16(std::shared_ptr<const LDPCConnectivity> conn)
+    {
+        return new Decoder<void, simd16_type, algorithm16_type>(std::move(conn));
+    }
+
+    static LDPCDecoderInterface* create(std::shared_ptr<const LDPCConnectivity> conn,
+                                        gr::dvbs2rx::dvb_standard_t standard,
+                                        gr::dvbs2rx::dvb_framesize_t framesize,
+                                        gr::dvbs2rx::dvb_code_rate_t rate)
+    {
+        return gr::dvbs2rx::visit_ldpc_table(
+            standard, framesize, rate, DecoderFactory{ std::move(conn) });
+    }
+
+    static void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len)
+    {
+        vpack_signs<int8_t, simd_type::SIZE>(bytes, soft, len);
+    }
+};
+
+#endif
@@ -0,0 +1,67 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018,2019,2024 Ahmet Inan, Ron Economos, Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef CONNECTIVITY_HH
+#define CONNECTIVITY_HH
+
+#include "ldpc.hh"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Check node connectivity prepared for the layered decoder.
+ *
+ * The bit node positions linked to each check node are stored with CNL entries per
+ * check node and ordered by group, i.e., check node "M * i + j" of the layered
+ * schedule is check node "q * j + i" of the parity check matrix. The structure does
+ * not depend on the SIMD type, so a single instance can be shared (read-only) by the
+ * decoders of all backends and threads using the same code.
+ */
+struct LDPCConnectivity {
+    int N, K, M, R, q, CNL, LT;
+    std::vector<uint16_t> pos;
+    std::vector<uint8_t> cnc;
+
+    explicit LDPCConnectivity(LDPCInterface* it)
+    {
+        LDPCInterface* ldpc = it->clone();
+        N = ldpc->code_len();
+        K = ldpc->data_len();
+        M = ldpc->group_len();
+        R = N - K;
+        q = R / M;
+        CNL = ldpc->links_max_cn() - 2;
+        LT = ldpc->links_total();
+        std::vector<uint16_t> tmp(R * CNL);
+        cnc.assign(R, 0);
+        ldpc->first_bit();
+        for (int j = 0; j < K; ++j) {
+            int* acc_pos = ldpc->acc_pos();
+            int bit_deg = ldpc->bit_deg();
+            for (int n = 0; n < bit_deg; ++n) {
+                int i = acc_pos[n];
+                tmp[CNL * i + cnc[i]++] = j;
+            }
+            ldpc->next_bit();
+        }
+        delete ldpc;
+        pos.resize(R * CNL);
+        for (int i = 0; i < q; ++i)
+            for (int j = 0; j < M; ++j)
+                for (int c = 0; c < CNL; ++c)
+                    pos[CNL * (M * i + j) + c] = tmp[CNL * (q * j + i) + c];
+    }
+    size_t size() const
+    {
+        return sizeof(*this) + pos.size() * sizeof(uint16_t) + cnc.size();
+    }
+};
+
+#endif
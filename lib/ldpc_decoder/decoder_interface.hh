@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef DECODER_INTERFACE_HH
+#define DECODER_INTERFACE_HH
+
+#include <cstdint>
+
+/*
+ * Interface to a self-contained LDPC decoder instance.
+ *
+ * Each SIMD backend (AVX2, SSE4.1, NEON, or generic) implements this interface on top
+ * of its own LDPCDecoder specialization. An instance owns all of its decoding state
+ * (connectivity tables, messages, and aligned working buffer), so independent
+ * instances can decode concurrently on separate threads.
+ */
+struct LDPCDecoderInterface {
+    // Name of the SIMD backend implementing the decoder.
+    virtual const char* impl() = 0;
+    // Number of codewords decoded in parallel (one per SIMD lane).
+    virtual int simd_size() = 0;
+    // Decode simd_size() consecutive codewords in place. Returns the number of unused
+    // trials, or a negative number if the decoder did not converge within "trials".
+    virtual int decode(int8_t* code, int trials) = 0;
+    // Decode simd_size() codewords read from "frames", one pointer per lane, without
+    // modifying them. A null pointer leaves its lane with an always valid codeword.
+    // The decoded codewords stay in the working buffer until the next decoding, so
+    // that they can be fetched through store() and pack() without further copies.
+    virtual int decode(const int8_t* const* frames, int trials) = 0;
+    // Same as above, but also storing the unused trials of each lane (or a negative
+    // number on failure) into "results", which must hold simd_size() entries.
+    virtual int decode(const int8_t* const* frames, int* results, int trials) = 0;
+    // Write the simd_size() codewords of the last decode(frames, trials) call
+    // consecutively into "code".
+    virtual void store(int8_t* code) = 0;
+    // Pack the hard decisions of the first "bits" bits of each codeword of the last
+    // decode(frames, trials) call into bits / 8 consecutive bytes per codeword, MSB
+    // first, reading them straight from the working buffer.
+    virtual void pack(uint8_t* bytes, int bits) = 0;
+    // Decode n_frames consecutive codewords in place, refilling each SIMD lane with the
+    // next codeword as soon as the current one converges. Stores the unused trials of
+    // each codeword (negative on failure) into "results" and returns the number of
+    // iterations executed over the SIMD vectors.
+    virtual int decode_rolling(int8_t* code, int n_frames, int* results, int trials) = 0;
+    // Same as above, but reading each codeword from "frames" and writing the decoded
+    // codewords consecutively into "code".
+    virtual int decode_rolling(const int8_t* const* frames,
+                               int8_t* code,
+                               int n_frames,
+                               int* results,
+                               int trials) = 0;
+    // Check the convergence only every "period" iterations rather than before each one,
+    // which saves the parity check passes at the cost of up to period - 1 iterations
+    // after convergence. Must not be called concurrently with decode().
+    virtual void set_check_period(int period) = 0;
+    virtual ~LDPCDecoderInterface() = default;
+};
+
+#endif
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2018 Ahmet Inan, Ron Economos.
+ * Copyright 2018,2024 Ahmet Inan, Ron Economos, Igor Freire.
  *
  * This file is part of gr-dvbs2rx.
  *
@@ -12,129 +12,192 @@
 
 #include "exclusive_reduce.hh"
 #include "ldpc.hh"
+#include <condition_variable>
+#include <mutex>
 #include <stdlib.h>
+#include <thread>
+#include <vector>
 
+/*
+ * Decoder with the flooding schedule, where all bit nodes are updated, then all check
+ * nodes, on each iteration. Unlike with the layered schedule, the nodes of each half
+ * iteration are independent of each other, so a single codeword can be split across
+ * threads: each thread updates its own range of bit nodes and then its own range of
+ * check nodes, with a barrier in between. This trades throughput for the latency of
+ * each codeword, as the layered decoders need a full batch of codewords to fill their
+ * SIMD lanes.
+ *
+ * The links are precomputed into tables by following the order in which the messages
+ * are exchanged with the IRA code structure, so the results do not depend on the
+ * number of threads.
+ */
 template <typename TYPE, typename ALG>
-class LDPCDecoder
+class LDPCFloodingDecoder
 {
     void* aligned_buffer;
-    TYPE *bnl, *bnv, *cnl, *cnv;
-    uint8_t* cnc;
-    LDPCInterface* ldpc;
+    TYPE *bnl, *bnv, *cnl, *cnv, *chv;
+    std::vector<int> cn_edge; // bnl index linked to each check node link
+    std::vector<int> cn_bit;  // bit node linked to each check node link
+    std::vector<int> bn_off;  // first bnl index of each bit node (N + 1 entries)
+    std::vector<int> bn_link; // cnl index linked to each bit node link
+    std::vector<uint8_t> cnc;
     ALG alg;
     int N, K, R, CNL, LT;
+    int check_period;
+    int blocks;
     bool initialized;
 
-    void bit_node_init(TYPE* data, TYPE* parity)
+    // Thread team, with thread 0 being the caller's thread
+    enum phase_t { PHASE_INIT, PHASE_BIT_NODES, PHASE_CHECK_NODES, PHASE_EXIT };
+    int num_threads;
+    std::vector<std::thread> workers;
+    std::vector<int> bn_range; // first bit node of each thread (num_threads + 1)
+    std::vector<int> cn_range; // first check node of each thread (num_threads + 1)
+    std::vector<char> bad_part;
+    std::mutex mutex;
+    std::condition_variable start_cv, done_cv;
+    phase_t phase;
+    unsigned generation;
+    int pending;
+
+    void bit_node_init(int begin, int end)
     {
-        TYPE* bl = bnl;
-        for (int i = 0; i < R - 1; ++i) {
-            bnv[i] = parity[i];
-            *bl++ = parity[i];
-            *bl++ = parity[i];
-        }
-        bnv[R - 1] = parity[R - 1];
-        *bl++ = parity[R - 1];
-        ldpc->first_bit();
-        for (int j = 0; j < K; ++j) {
-            bnv[j + R] = data[j];
-            int bit_deg = ldpc->bit_deg();
-            for (int n = 0; n < bit_deg; ++n)
-                *bl++ = data[j];
-            ldpc->next_bit();
+        for (int b = begin; b < end; ++b) {
+            bnv[b] = chv[b];
+            for (int e = bn_off[b]; e < bn_off[b + 1]; ++e)
+                bnl[e] = chv[b];
         }
     }
-    void check_node_update()
+    bool check_node_update(int begin, int end)
     {
-        TYPE* bl = bnl;
-        cnv[0] = alg.sign(alg.one(), bnv[0]);
-        cnl[0] = *bl++;
-        cnc[0] = 1;
-        for (int i = 1; i < R; ++i) {
-            cnv[i] = alg.sign(alg.sign(alg.one(), bnv[i - 1]), bnv[i]);
-            cnl[CNL * i] = *bl++;
-            cnl[CNL * i + 1] = *bl++;
-            cnc[i] = 2;
+        bool bad = false;
+        for (int i = begin; i < end; ++i) {
+            TYPE* links = cnl + CNL * i;
+            TYPE v = alg.one();
+            for (int c = 0; c < cnc[i]; ++c) {
+                links[c] = bnl[cn_edge[CNL * i + c]];
+                v = alg.sign(v, bnv[cn_bit[CNL * i + c]]);
+            }
+            cnv[i] = v;
+            bad = bad || alg.bad(v, blocks);
+            alg.finalp(links, cnc[i]);
         }
-        ldpc->first_bit();
-        for (int j = 0; j < K; ++j) {
-            int* acc_pos = ldpc->acc_pos();
-            int bit_deg = ldpc->bit_deg();
-            for (int n = 0; n < bit_deg; ++n) {
-                int i = acc_pos[n];
-                cnv[i] = alg.sign(cnv[i], bnv[j + R]);
-                cnl[CNL * i + cnc[i]++] = *bl++;
+        return bad;
+    }
+    void bit_node_update(int begin, int end)
+    {
+        for (int b = begin; b < end; ++b) {
+            const int off = bn_off[b];
+            const int deg = bn_off[b + 1] - off;
+            if (deg == 1) {
+                bnv[b] = alg.add(chv[b], cnl[bn_link[off]]);
+                alg.update(bnl + off, chv[b]);
+                continue;
             }
-            ldpc->next_bit();
+            TYPE inp[deg];
+            for (int n = 0; n < deg; ++n)
+                inp[n] = cnl[bn_link[off + n]];
+            TYPE out[deg];
+            CODE::exclusive_reduce(inp, out, deg, alg.add);
+            bnv[b] = alg.add(chv[b], alg.add(out[0], inp[0]));
+            for (int n = 0; n < deg; ++n)
+                alg.update(bnl + off + n, alg.add(chv[b], out[n]));
         }
-        for (int i = 0; i < R; ++i)
-            alg.finalp(cnl + CNL * i, cnc[i]);
     }
-    void bit_node_update(TYPE* data, TYPE* parity)
+    void run_part(phase_t p, int t)
     {
-        TYPE* bl = bnl;
-        bnv[0] = alg.add(parity[0], alg.add(cnl[0], cnl[CNL]));
-        alg.update(bl++, alg.add(parity[0], cnl[CNL]));
-        alg.update(bl++, alg.add(parity[0], cnl[0]));
-        cnc[0] = 1;
-        for (int i = 1; i < R - 1; ++i) {
-            bnv[i] = alg.add(parity[i], alg.add(cnl[CNL * i + 1], cnl[CNL * (i + 1)]));
-            alg.update(bl++, alg.add(parity[i], cnl[CNL * (i + 1)]));
-            alg.update(bl++, alg.add(parity[i], cnl[CNL * i + 1]));
-            cnc[i] = 2;
+        switch (p) {
+        case PHASE_INIT:
+            bit_node_init(bn_range[t], bn_range[t + 1]);
+            break;
+        case PHASE_BIT_NODES:
+            bit_node_update(bn_range[t], bn_range[t + 1]);
+            break;
+        case PHASE_CHECK_NODES:
+            bad_part[t] = check_node_update(cn_range[t], cn_range[t + 1]);
+            break;
+        default:
+            break;
         }
-        bnv[R - 1] = alg.add(parity[R - 1], cnl[CNL * (R - 1) + 1]);
-        alg.update(bl++, parity[R - 1]);
-        cnc[R - 1] = 2;
-        ldpc->first_bit();
-        for (int j = 0; j < K; ++j) {
-            int* acc_pos = ldpc->acc_pos();
-            int bit_deg = ldpc->bit_deg();
-            TYPE inp[bit_deg];
-            for (int n = 0; n < bit_deg; ++n) {
-                int i = acc_pos[n];
-                inp[n] = cnl[CNL * i + cnc[i]++];
-            }
-            TYPE out[bit_deg];
-            CODE::exclusive_reduce(inp, out, bit_deg, alg.add);
-            bnv[j + R] = alg.add(data[j], alg.add(out[0], inp[0]));
-            for (int n = 0; n < bit_deg; ++n)
-                alg.update(bl++, alg.add(data[j], out[n]));
-            ldpc->next_bit();
+    }
+    // Run a phase on all threads and wait for its completion. Returns whether any
+    // parity check failed, as evaluated by the last check node update.
+    bool run(phase_t p)
+    {
+        if (num_threads == 1) {
+            run_part(p, 0);
+            return bad_part[0];
         }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            phase = p;
+            generation++;
+            pending = num_threads - 1;
+        }
+        start_cv.notify_all();
+        run_part(p, 0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [this] { return pending == 0; });
+        bool bad = false;
+        for (int t = 0; t < num_threads; ++t)
+            bad = bad || bad_part[t];
+        return bad;
     }
-    bool hard_decision(int blocks)
+    void worker(int t)
     {
-        for (int i = 0; i < R; ++i)
-            if (alg.bad(cnv[i], blocks))
-                return true;
-        return false;
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            start_cv.wait(lock, [this, seen] { return generation != seen; });
+            seen = generation;
+            const phase_t p = phase;
+            if (p == PHASE_EXIT)
+                return;
+            lock.unlock();
+            run_part(p, t);
+            lock.lock();
+            if (--pending == 0)
+                done_cv.notify_one();
+        }
     }
-    void update_user(TYPE* data, TYPE* parity)
+    void stop()
     {
-        for (int i = 0; i < R; ++i)
-            parity[i] = bnv[i];
-        for (int i = 0; i < K; ++i)
-            data[i] = bnv[i + R];
+        if (workers.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            phase = PHASE_EXIT;
+            generation++;
+        }
+        start_cv.notify_all();
+        for (auto& thread : workers)
+            thread.join();
+        workers.clear();
+    }
+    void release()
+    {
+        stop();
+        if (initialized)
+            free(aligned_buffer);
+        initialized = false;
     }
 
 public:
-    LDPCDecoder() : initialized(false) {}
-    void init(LDPCInterface* it)
+    LDPCFloodingDecoder()
+        : check_period(1), blocks(1), initialized(false), num_threads(1), generation(0)
     {
-        if (initialized) {
-            free(aligned_buffer);
-            delete[] cnc;
-            delete ldpc;
-        }
+    }
+    void init(LDPCInterface* it, int threads = 1)
+    {
+        release();
         initialized = true;
-        ldpc = it->clone();
+        LDPCInterface* ldpc = it->clone();
         N = ldpc->code_len();
         K = ldpc->data_len();
         R = N - K;
         CNL = ldpc->links_max_cn();
         LT = ldpc->links_total();
-        int num = LT + N + R * CNL + R;
+        int num = LT + N + R * CNL + R + N;
         aligned_buffer = aligned_alloc(sizeof(TYPE), sizeof(TYPE) * num);
         TYPE* ptr = reinterpret_cast<TYPE*>(aligned_buffer);
         bnl = ptr;
@@ -145,32 +208,104 @@ public:
         ptr += R * CNL;
         cnv = ptr;
         ptr += R;
-        cnc = new uint8_t[R];
+        chv = ptr;
+
+        // Bit nodes 0 to R - 1 are the parity bits, and R to N - 1 the message bits.
+        // Parity bit i links to check nodes i and i + 1 (only i for the last one).
+        cn_edge.assign(R * CNL, 0);
+        cn_bit.assign(R * CNL, 0);
+        bn_off.assign(N + 1, 0);
+        bn_link.assign(LT, 0);
+        cnc.assign(R, 0);
+        for (int i = 0; i < R; ++i) {
+            bn_off[i] = 2 * i;
+            if (i > 0) {
+                cn_edge[CNL * i + cnc[i]] = 2 * i - 1;
+                cn_bit[CNL * i + cnc[i]++] = i - 1;
+            }
+            cn_edge[CNL * i + cnc[i]] = 2 * i;
+            cn_bit[CNL * i + cnc[i]++] = i;
+        }
+        int e = 2 * R - 1;
+        ldpc->first_bit();
+        for (int j = 0; j < K; ++j) {
+            bn_off[R + j] = e;
+            int* acc_pos = ldpc->acc_pos();
+            int bit_deg = ldpc->bit_deg();
+            for (int n = 0; n < bit_deg; ++n) {
+                int i = acc_pos[n];
+                cn_edge[CNL * i + cnc[i]] = e++;
+                cn_bit[CNL * i + cnc[i]++] = R + j;
+            }
+            ldpc->next_bit();
+        }
+        bn_off[N] = e;
+        delete ldpc;
+        for (int i = 0; i < R; ++i)
+            for (int c = 0; c < cnc[i]; ++c)
+                bn_link[cn_edge[CNL * i + c]] = CNL * i + c;
+
+        // Balance the bit node ranges by number of links, as the message bits have
+        // higher degrees than the parity bits
+        num_threads = threads < 1 ? 1 : threads;
+        bn_range.assign(num_threads + 1, N);
+        cn_range.assign(num_threads + 1, R);
+        bad_part.assign(num_threads, 0);
+        for (int t = 0, b = 0; t < num_threads; ++t) {
+            while (bn_off[b] < (long)LT * t / num_threads)
+                ++b;
+            bn_range[t] = b;
+            cn_range[t] = (long)R * t / num_threads;
+        }
+        for (int t = 1; t < num_threads; ++t)
+            workers.emplace_back(&LDPCFloodingDecoder::worker, this, t);
     }
-    int operator()(TYPE* data, TYPE* parity, int trials = 50, int blocks = 1)
+    // Check the parity equations only every "period" iterations (and on the last
+    // trial), as with the layered decoder.
+    void set_check_period(int period) { check_period = period < 1 ? 1 : period; }
+    // Decode the codeword read from "code" (message bits followed by parity bits)
+    // without modifying it. The decoded codeword remains available for store() and
+    // pack() until the next decoding.
+    int operator()(const TYPE* code, int trials = 25, int blocks = 1)
     {
-        bit_node_init(data, parity);
-        check_node_update();
-        if (!hard_decision(blocks))
-            return trials;
-        --trials;
-        bit_node_update(data, parity);
-        check_node_update();
-        while (hard_decision(blocks) && --trials >= 0) {
-            bit_node_update(data, parity);
-            check_node_update();
+        this->blocks = blocks;
+        for (int i = 0; i < R; ++i)
+            chv[i] = code[K + i];
+        for (int j = 0; j < K; ++j)
+            chv[R + j] = code[j];
+        run(PHASE_INIT);
+        bool bad = run(PHASE_CHECK_NODES);
+        for (int iteration = 0;; ++iteration) {
+            bool check = iteration % check_period == 0 || !trials;
+            if ((check && !bad) || --trials < 0)
+                break;
+            run(PHASE_BIT_NODES);
+            bad = run(PHASE_CHECK_NODES);
         }
-        update_user(data, parity);
         return trials;
     }
-    ~LDPCDecoder()
+    // Write the codeword left by the last decoding into "code".
+    void store(TYPE* code)
     {
-        if (initialized) {
-            free(aligned_buffer);
-            delete[] cnc;
-            delete ldpc;
+        for (int j = 0; j < K; ++j)
+            code[j] = bnv[R + j];
+        for (int i = 0; i < R; ++i)
+            code[K + i] = bnv[i];
+    }
+    // Pack the hard decisions of the first "bits" bits of the codeword left by the
+    // last decoding into bits / 8 bytes, MSB first. Only for single-lane types.
+    void pack(uint8_t* bytes, int bits)
+    {
+        for (int k = 0; k < bits; k += 8) {
+            uint8_t byte = 0;
+            for (int n = k; n < k + 8; ++n) {
+                const TYPE& v = n < K ? bnv[R + n] : bnv[n - K];
+                byte = (byte << 1) | (v.v[0] < 0);
+            }
+            bytes[k / 8] = byte;
         }
     }
+    ~LDPCFloodingDecoder() { release(); }
 };
 
 #endif
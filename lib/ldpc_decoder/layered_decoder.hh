@@ -10,27 +10,98 @@
 #ifndef LAYERED_DECODER_HH
 #define LAYERED_DECODER_HH
 
+#include "connectivity.hh"
 #include "ldpc.hh"
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <stdlib.h>
+#include <type_traits>
+#include <vector>
 
-template <typename TYPE, typename ALG>
+// Range of check node degrees (excluding the two parity links) known at compile time
+template <typename TABLE>
+struct CheckNodeDegrees {
+    static const int MIN = TABLE::LINKS_MIN_CN > 3 ? TABLE::LINKS_MIN_CN - 2 : 1;
+    static const int MAX = TABLE::LINKS_MAX_CN - 2;
+};
+
+template <>
+struct CheckNodeDegrees<void> {
+    static const int MIN = 1;
+    static const int MAX = 0;
+};
+
+// Number of bits by which the algorithm scales up the 8-bit input LLRs in its wider
+// lanes, if any (see the 16-bit OffsetMinSumAlgorithm)
+template <typename ALG, typename = void>
+struct InputShift {
+    static const int value = 0;
+};
+
+template <typename ALG>
+struct InputShift<ALG, std::void_t<decltype(ALG::SHIFT)>> {
+    static const int value = ALG::SHIFT;
+};
+
+// When TABLE is given, the check nodes whose degree lies within the range defined by
+// the table are processed by code specialized for each degree, with all loops over
+// the links unrolled by the compiler. The codewords are always given as 8-bit LLRs,
+// whereas the lanes of TYPE may be wider, in which case the LLRs are scaled up by
+// InputShift<ALG> on loading and back down on storing.
+template <typename TYPE, typename ALG, typename TABLE = void>
 class LDPCDecoder
 {
-    typedef typename TYPE::value_type code_type;
+    typedef int8_t code_type;
+    typedef typename TYPE::value_type value_type;
+    static const int SHIFT = InputShift<ALG>::value;
+    static const bool WIDE = sizeof(value_type) > sizeof(code_type);
     TYPE *bnl, *pty;
-    uint16_t* pos;
-    uint8_t* cnc;
+    std::shared_ptr<const LDPCConnectivity> conn;
+    const uint16_t* pos;
+    const uint8_t* cnc;
+    std::vector<code_type> padding;
     ALG alg;
     int M, N, K, R, q, CNL, LT;
+    int check_period;
     bool initialized;
 
+    typedef decltype(vcgtz(TYPE())) mask_type;
+
     void reset()
     {
         for (int i = 0; i < LT; ++i)
             bnl[i] = alg.zero();
     }
-    bool bad(TYPE* data, TYPE* parity, int blocks)
+    mask_type good_lanes(TYPE* data, TYPE* parity, const int* frame)
+    {
+        mask_type good = vcgtz(alg.one());
+        for (int i = 0; i < q; ++i) {
+            int cnt = cnc[i];
+            for (int j = 0; j < M; ++j) {
+                TYPE cnv = alg.sign(alg.one(), parity[M * i + j]);
+                if (i)
+                    cnv = alg.sign(cnv, parity[M * (i - 1) + j]);
+                else if (j)
+                    cnv = alg.sign(cnv, parity[j + (q - 1) * M - 1]);
+                for (int c = 0; c < cnt; ++c)
+                    cnv = alg.sign(cnv, data[pos[CNL * (M * i + j) + c]]);
+                good = vand(good, vcgtz(cnv));
+            }
+            // stop early once every lane in use has an unsatisfied check
+            bool any = false;
+            for (int n = 0; n < TYPE::SIZE; ++n)
+                any |= frame[n] >= 0 && good.v[n];
+            if (!any)
+                break;
+        }
+        return good;
+    }
+    // Check whether any lane has an unsatisfied parity check. The check node signs are
+    // combined into a lane mask, which is tested once per group of M check nodes.
+    bool bad(TYPE* data, TYPE* parity)
     {
+        mask_type good = vcgtz(alg.one());
         for (int i = 0; i < q; ++i) {
             int cnt = cnc[i];
             for (int j = 0; j < M; ++j) {
@@ -41,9 +112,70 @@ class LDPCDecoder
                     cnv = alg.sign(cnv, parity[j + (q - 1) * M - 1]);
                 for (int c = 0; c < cnt; ++c)
                     cnv = alg.sign(cnv, data[pos[CNL * (M * i + j) + c]]);
-                if (alg.bad(cnv, blocks))
+                good = vand(good, vcgtz(cnv));
+            }
+            for (int n = 0; n < TYPE::SIZE; ++n)
+                if (!good.v[n])
                     return true;
+        }
+        return false;
+    }
+    // Load the codewords of "frames" (or the padding codeword for null pointers) into
+    // the lanes, and the parity bits into their own layout, clearing the messages.
+    void load(TYPE* data, const code_type* const* frames)
+    {
+        TYPE* parity = data + K;
+        const code_type* rows[TYPE::SIZE];
+        for (int n = 0; n < TYPE::SIZE; ++n)
+            rows[n] = frames[n] ? frames[n] : padding.data();
+        if constexpr (WIDE)
+            vload_transposed(data, rows, N, SHIFT);
+        else
+            vload_transposed(data, rows, N);
+        reset();
+        for (int i = 0; i < q; ++i)
+            for (int j = 0; j < M; ++j)
+                pty[M * i + j] = parity[q * j + i];
+    }
+    // Move the parity bits back after the codeword bits
+    void unload(TYPE* data)
+    {
+        TYPE* parity = data + K;
+        for (int i = 0; i < q; ++i)
+            for (int j = 0; j < M; ++j)
+                parity[q * j + i] = pty[M * i + j];
+    }
+    template <int CNT>
+    void update_group(TYPE*& bl, TYPE* data, TYPE* parity, int i)
+    {
+        const int deg = CNT + 2;
+        for (int j = 0; j < M; ++j) {
+            const uint16_t* p = pos + CNL * (M * i + j);
+            TYPE* cur = parity + M * i + j;
+            TYPE* prv = parity + M * (i - 1) + j;
+            TYPE inp[deg], out[deg];
+            for (int c = 0; c < CNT; ++c)
+                inp[c] = out[c] = alg.sub(data[p[c]], bl[c]);
+            inp[CNT] = out[CNT] = alg.sub(*cur, bl[CNT]);
+            inp[CNT + 1] = out[CNT + 1] = alg.sub(*prv, bl[CNT + 1]);
+            alg.finalp(out, deg);
+            for (int c = 0; c < CNT; ++c)
+                data[p[c]] = alg.add(inp[c], out[c]);
+            *cur = alg.add(inp[CNT], out[CNT]);
+            *prv = alg.add(inp[CNT + 1], out[CNT + 1]);
+            for (int d = 0; d < deg; ++d)
+                alg.update(bl++, out[d]);
+        }
+    }
+    template <int CNT>
+    bool update_fixed(TYPE*& bl, TYPE* data, TYPE* parity, int i, int cnt)
+    {
+        if constexpr (CNT >= CheckNodeDegrees<TABLE>::MIN) {
+            if (cnt == CNT) {
+                update_group<CNT>(bl, data, parity, i);
+                return true;
             }
+            return update_fixed<CNT - 1>(bl, data, parity, i, cnt);
         }
         return false;
     }
@@ -52,6 +184,9 @@ class LDPCDecoder
         TYPE* bl = bnl;
         for (int i = 0; i < q; ++i) {
             int cnt = cnc[i];
+            // the first group has a check node with a single parity link
+            if (i && update_fixed<CheckNodeDegrees<TABLE>::MAX>(bl, data, parity, i, cnt))
+                continue;
             for (int j = 0; j < M; ++j) {
                 int deg = cnt + 2 - !(i | j);
                 TYPE inp[deg], out[deg];
@@ -78,93 +213,221 @@ class LDPCDecoder
         }
     }
 
-    void serial_to_parallel(TYPE* data, code_type* code)
+    static value_type widen(code_type v) { return value_type(v) * (1 << SHIFT); }
+    static code_type narrow(value_type v)
     {
-        for (int n = 0; n < TYPE::SIZE; n++) {
-            for (int j = 0; j < N; j++) {
-                reinterpret_cast<code_type*>(data + j)[n] = code[(n * N) + j];
-            }
-        }
+        return std::min<value_type>(std::max<value_type>(v >> SHIFT, -128), 127);
     }
 
-    void parallel_to_serial(TYPE* data, code_type* code)
+    void load_lane(TYPE* data, int lane, const code_type* code)
     {
-        for (int n = 0; n < TYPE::SIZE; n++) {
-            for (int j = 0; j < N; j++) {
-                code[(n * N) + j] = reinterpret_cast<code_type*>(data + j)[n];
-            }
-        }
+        for (int j = 0; j < K; ++j)
+            reinterpret_cast<value_type*>(data + j)[lane] = widen(code[j]);
+        for (int i = 0; i < q; ++i)
+            for (int j = 0; j < M; ++j)
+                reinterpret_cast<value_type*>(pty + M * i + j)[lane] =
+                    widen(code[K + q * j + i]);
+    }
+
+    void store_lane(TYPE* data, int lane, code_type* code)
+    {
+        for (int j = 0; j < K; ++j)
+            code[j] = narrow(reinterpret_cast<value_type*>(data + j)[lane]);
+        for (int i = 0; i < q; ++i)
+            for (int j = 0; j < M; ++j)
+                code[K + q * j + i] =
+                    narrow(reinterpret_cast<value_type*>(pty + M * i + j)[lane]);
     }
 
 public:
-    LDPCDecoder() : initialized(false) {}
-    void init(LDPCInterface* it)
+    LDPCDecoder() : check_period(1), initialized(false) {}
+    // Check the parity equations only every "period" iterations (and on the last
+    // trial), instead of before every iteration. Once a codeword converges, up to
+    // period - 1 extra iterations run before the decoder stops.
+    void set_check_period(int period) { check_period = period < 1 ? 1 : period; }
+    void init(LDPCInterface* it) { init(std::make_shared<const LDPCConnectivity>(it)); }
+    void init(std::shared_ptr<const LDPCConnectivity> connectivity)
     {
         if (initialized) {
             free(bnl);
             free(pty);
-            delete[] cnc;
-            delete[] pos;
         }
         initialized = true;
-        LDPCInterface* ldpc = it->clone();
-        N = ldpc->code_len();
-        K = ldpc->data_len();
-        M = ldpc->group_len();
-        R = N - K;
-        q = R / M;
-        CNL = ldpc->links_max_cn() - 2;
-        pos = new uint16_t[R * CNL];
-        cnc = new uint8_t[R];
-        for (int i = 0; i < R; ++i)
-            cnc[i] = 0;
-        ldpc->first_bit();
-        for (int j = 0; j < K; ++j) {
-            int* acc_pos = ldpc->acc_pos();
-            int bit_deg = ldpc->bit_deg();
-            for (int n = 0; n < bit_deg; ++n) {
-                int i = acc_pos[n];
-                pos[CNL * i + cnc[i]++] = j;
-            }
-            ldpc->next_bit();
-        }
-        LT = ldpc->links_total();
-        delete ldpc;
+        conn = std::move(connectivity);
+        N = conn->N;
+        K = conn->K;
+        M = conn->M;
+        R = conn->R;
+        q = conn->q;
+        CNL = conn->CNL;
+        LT = conn->LT;
+        pos = conn->pos.data();
+        cnc = conn->cnc.data();
         bnl = reinterpret_cast<TYPE*>(aligned_alloc(sizeof(TYPE), sizeof(TYPE) * LT));
         pty = reinterpret_cast<TYPE*>(aligned_alloc(sizeof(TYPE), sizeof(TYPE) * R));
-        uint16_t* tmp = new uint16_t[R * CNL];
-        for (int i = 0; i < q; ++i)
-            for (int j = 0; j < M; ++j)
-                for (int c = 0; c < CNL; ++c)
-                    tmp[CNL * (M * i + j) + c] = pos[CNL * (q * j + i) + c];
-        delete[] pos;
-        pos = tmp;
+        // codeword satisfying all checks with maximum reliability, for unused lanes
+        padding.assign(N, std::numeric_limits<code_type>::max());
     }
     int operator()(void* buffer, code_type* code, int trials = 25)
     {
-        const int blocks = TYPE::SIZE;
+        const code_type* frames[TYPE::SIZE];
+        for (int n = 0; n < TYPE::SIZE; ++n)
+            frames[n] = code + n * N;
+        trials = (*this)(buffer, frames, trials);
+        store(buffer, code);
+        return trials;
+    }
+    // Decode the codewords read from "frames", one per lane, without writing them back.
+    // A null frame pointer leaves its lane with an always valid codeword. The decoded
+    // codewords remain in the buffer for store() and pack().
+    int operator()(void* buffer, const code_type* const* frames, int trials = 25)
+    {
         TYPE* data = reinterpret_cast<TYPE*>(buffer);
-        TYPE* parity = data + K;
-        serial_to_parallel(data, code);
-        reset();
-        for (int i = 0; i < q; ++i)
-            for (int j = 0; j < M; ++j)
-                pty[M * i + j] = parity[q * j + i];
-        while (bad(data, pty, blocks) && --trials >= 0)
+        load(data, frames);
+        for (int iteration = 0;; ++iteration) {
+            bool check = iteration % check_period == 0 || !trials;
+            if ((check && !bad(data, pty)) || --trials < 0)
+                break;
             update(data, pty);
-        for (int i = 0; i < q; ++i)
-            for (int j = 0; j < M; ++j)
-                parity[q * j + i] = pty[M * i + j];
-        parallel_to_serial(data, code);
+        }
+        unload(data);
         return trials;
     }
+    // Same as above, but also tracking the convergence of each lane, whose unused
+    // trials at the first check passed by its codeword (or a negative number on
+    // failure) are stored into "results". The lanes of null frame pointers converge
+    // immediately. Costs a full parity check whenever any lane converges.
+    int operator()(void* buffer,
+                   const code_type* const* frames,
+                   int* results,
+                   int trials = 25)
+    {
+        TYPE* data = reinterpret_cast<TYPE*>(buffer);
+        load(data, frames);
+        int lane[TYPE::SIZE]; // non-negative while the lane has not converged
+        int pending = TYPE::SIZE;
+        for (int n = 0; n < TYPE::SIZE; ++n) {
+            lane[n] = n;
+            results[n] = -1;
+        }
+        for (int iteration = 0;; ++iteration) {
+            bool check = iteration % check_period == 0 || !trials;
+            if (check) {
+                mask_type good = good_lanes(data, pty, lane);
+                for (int n = 0; n < TYPE::SIZE; ++n) {
+                    if (lane[n] < 0 || !good.v[n])
+                        continue;
+                    results[n] = trials;
+                    lane[n] = -1;
+                    --pending;
+                }
+            }
+            if (!pending || --trials < 0)
+                break;
+            update(data, pty);
+        }
+        unload(data);
+        return trials;
+    }
+    // Write the codewords left in the buffer by the last decoding into "code".
+    void store(void* buffer, code_type* code)
+    {
+        const TYPE* data = reinterpret_cast<const TYPE*>(buffer);
+        if constexpr (WIDE) {
+            code_type* rows[TYPE::SIZE];
+            for (int n = 0; n < TYPE::SIZE; ++n)
+                rows[n] = code + n * N;
+            vstore_transposed(rows, data, N, SHIFT);
+        } else {
+            vstore_transposed(code, data, N);
+        }
+    }
+    // Pack the hard decisions of the first "bits" bits of the codewords left in the
+    // buffer by the last decoding into "bytes", with bits / 8 bytes per codeword.
+    void pack(void* buffer, uint8_t* bytes, int bits)
+    {
+        uint8_t* rows[TYPE::SIZE];
+        for (int n = 0; n < TYPE::SIZE; ++n)
+            rows[n] = bytes + n * (bits / 8);
+        vpack_signs_transposed(rows, reinterpret_cast<const TYPE*>(buffer), bits);
+    }
+    // Decode "frames" consecutive codewords in place while recycling the SIMD lanes:
+    // as soon as the codeword on a lane satisfies all parity checks (or runs out of
+    // trials), it is written back and the lane is refilled with the next pending
+    // codeword. Each codeword thus costs about its own number of iterations rather
+    // than the number required by the worst codeword of a batch. Stores the number of
+    // unused trials of each codeword (or a negative number on failure) into "results"
+    // and returns the number of layered iterations executed over the SIMD vectors.
+    int rolling(void* buffer, code_type* code, int frames, int* results, int trials = 25)
+    {
+        std::vector<const code_type*> input(frames);
+        for (int f = 0; f < frames; ++f)
+            input[f] = code + f * N;
+        return rolling(buffer, input.data(), code, frames, results, trials);
+    }
+    // Same as above, but reading each codeword from "input" and writing the decoded
+    // codewords consecutively into "code".
+    int rolling(void* buffer,
+                const code_type* const* input,
+                code_type* code,
+                int frames,
+                int* results,
+                int trials = 25)
+    {
+        TYPE* data = reinterpret_cast<TYPE*>(buffer);
+        int frame[TYPE::SIZE]; // codeword index on each lane, negative if idle
+        int left[TYPE::SIZE];  // unused trials on each lane
+        // idle lanes hold the all-zero codeword, which satisfies all checks
+        for (int j = 0; j < K; ++j)
+            data[j] = alg.one();
+        for (int i = 0; i < R; ++i)
+            pty[i] = alg.one();
+        for (int n = 0; n < TYPE::SIZE; ++n)
+            frame[n] = -1;
+        int next = 0, busy = 0, iterations = 0;
+        while (true) {
+            if (next < frames && busy < TYPE::SIZE) {
+                // refill all idle lanes, then clear their messages in a single pass
+                mask_type keep = vceqz(alg.zero());
+                for (int n = 0; n < TYPE::SIZE && next < frames; ++n) {
+                    if (frame[n] >= 0)
+                        continue;
+                    load_lane(data, n, input[next]);
+                    keep.v[n] = 0;
+                    left[n] = trials;
+                    frame[n] = next++;
+                    ++busy;
+                }
+                for (int i = 0; i < LT; ++i)
+                    bnl[i] = vreinterpret<TYPE>(vand(vmask(bnl[i]), keep));
+            }
+            if (!busy)
+                break;
+            // lanes on their last trial must be checked regardless of the period
+            bool check = iterations % check_period == 0;
+            for (int n = 0; n < TYPE::SIZE; ++n)
+                check |= frame[n] >= 0 && !left[n];
+            mask_type good = check ? good_lanes(data, pty, frame) : vcgtz(alg.zero());
+            for (int n = 0; n < TYPE::SIZE; ++n) {
+                if (frame[n] < 0 || (!good.v[n] && --left[n] >= 0))
+                    continue;
+                store_lane(data, n, code + frame[n] * N);
+                results[frame[n]] = left[n];
+                frame[n] = -1;
+                --busy;
+            }
+            if (busy) {
+                update(data, pty);
+                ++iterations;
+            }
+        }
+        return iterations;
+    }
     ~LDPCDecoder()
     {
         if (initialized) {
             free(bnl);
             free(pty);
-            delete[] cnc;
-            delete[] pos;
         }
     }
 };
@@ -7,24 +7,39 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
 
-#include "algorithms.hh"
-#include "layered_decoder.hh"
-
-#define FACTOR 2
+#include "backend_impl.hh"
 
 namespace ldpc_avx2 {
 
-typedef SIMD<int8_t, 32> simd_type;
-typedef NormalUpdate<simd_type> update_type;
-typedef OffsetMinSumAlgorithm<simd_type, update_type, FACTOR> algorithm_type;
+struct backend {
+    typedef SIMD<int8_t, 32> simd_type;
+    typedef SIMD<int16_t, 16> simd16_type;
+    static constexpr const char* name = "avx2";
+    static constexpr const char* name16 = "avx2_int16";
+};
+typedef LDPCBackend<backend> impl;
+
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn)
+{
+    return impl::create(std::move(conn));
+}
 
-LDPCDecoder<simd_type, algorithm_type> LdpcDecoder;
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn)
+{
+    return impl::create16(std::move(conn));
+}
 
-void ldpc_dec_init(LDPCInterface* it) { LdpcDecoder.init(it); }
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate)
+{
+    return impl::create(std::move(conn), standard, framesize, rate);
+}
 
-int ldpc_dec_decode(void* buffer, int8_t* code, int trials)
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len)
 {
-    return LdpcDecoder(buffer, code, trials);
+    impl::pack_hard_decisions(bytes, soft, len);
 }
 
 } // namespace ldpc_avx2
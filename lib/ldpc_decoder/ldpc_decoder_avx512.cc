@@ -0,0 +1,45 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "backend_impl.hh"
+
+namespace ldpc_avx512 {
+
+struct backend {
+    typedef SIMD<int8_t, 64> simd_type;
+    typedef SIMD<int16_t, 32> simd16_type;
+    static constexpr const char* name = "avx512bw";
+    static constexpr const char* name16 = "avx512bw_int16";
+};
+typedef LDPCBackend<backend> impl;
+
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn)
+{
+    return impl::create(std::move(conn));
+}
+
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn)
+{
+    return impl::create16(std::move(conn));
+}
+
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate)
+{
+    return impl::create(std::move(conn), standard, framesize, rate);
+}
+
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len)
+{
+    impl::pack_hard_decisions(bytes, soft, len);
+}
+
+} // namespace ldpc_avx512
@@ -7,24 +7,113 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
 
-#include "algorithms.hh"
-#include "layered_decoder.hh"
-
-#define FACTOR 2
+#include "backend_impl.hh"
+#include "flooding_decoder.hh"
+#include <vector>
 
 namespace ldpc_generic {
 
-typedef SIMD<int8_t, 16> simd_type;
-typedef NormalUpdate<simd_type> update_type;
-typedef OffsetMinSumAlgorithm<simd_type, update_type, FACTOR> algorithm_type;
+struct backend {
+    typedef SIMD<int8_t, 16> simd_type;
+    typedef SIMD<int16_t, 8> simd16_type;
+    static constexpr const char* name = "generic";
+    static constexpr const char* name16 = "generic_int16";
+};
+typedef LDPCBackend<backend> impl;
+
+// Single-codeword decoder with the flooding schedule, split across threads
+typedef SIMD<int8_t, 1> flooding_type;
+typedef OffsetMinSumAlgorithm<flooding_type, NormalUpdate<flooding_type>, FACTOR>
+    flooding_algorithm_type;
+
+class FloodingDecoder : public LDPCDecoderInterface
+{
+    LDPCFloodingDecoder<flooding_type, flooding_algorithm_type> decoder;
+    std::vector<int8_t> padding;
+    int N;
+
+    static const flooding_type* cast(const int8_t* code)
+    {
+        return reinterpret_cast<const flooding_type*>(code);
+    }
+    static flooding_type* cast(int8_t* code)
+    {
+        return reinterpret_cast<flooding_type*>(code);
+    }
+
+public:
+    FloodingDecoder(LDPCInterface* ldpc, int num_threads)
+        : padding(ldpc->code_len(), 127), N(ldpc->code_len())
+    {
+        decoder.init(ldpc, num_threads);
+    }
+    const char* impl() { return "flooding"; }
+    int simd_size() { return 1; }
+    int decode(int8_t* code, int trials)
+    {
+        trials = decoder(cast(code), trials);
+        decoder.store(cast(code));
+        return trials;
+    }
+    int decode(const int8_t* const* frames, int trials)
+    {
+        return decoder(cast(frames[0] ? frames[0] : padding.data()), trials);
+    }
+    int decode(const int8_t* const* frames, int* results, int trials)
+    {
+        return results[0] = decode(frames, trials);
+    }
+    void store(int8_t* code) { decoder.store(cast(code)); }
+    void pack(uint8_t* bytes, int bits) { decoder.pack(bytes, bits); }
+    int decode_rolling(int8_t* code, int n_frames, int* results, int trials)
+    {
+        int iterations = 0;
+        for (int i = 0; i < n_frames; ++i) {
+            results[i] = decode(code + i * N, trials);
+            iterations += results[i] < 0 ? trials : trials - results[i];
+        }
+        return iterations;
+    }
+    int decode_rolling(
+        const int8_t* const* frames, int8_t* code, int n_frames, int* results, int trials)
+    {
+        int iterations = 0;
+        for (int i = 0; i < n_frames; ++i) {
+            results[i] = decoder(cast(frames[i]), trials);
+            decoder.store(cast(code + i * N));
+            iterations += results[i] < 0 ? trials : trials - results[i];
+        }
+        return iterations;
+    }
+    void set_check_period(int period) { decoder.set_check_period(period); }
+};
+
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn)
+{
+    return impl::create(std::move(conn));
+}
+
+LDPCDecoderInterface* ldpc_dec16_create(std::shared_ptr<const LDPCConnectivity> conn)
+{
+    return impl::create16(std::move(conn));
+}
 
-LDPCDecoder<simd_type, algorithm_type> LdpcDecoder;
+LDPCDecoderInterface* ldpc_dec_create(std::shared_ptr<const LDPCConnectivity> conn,
+                                      gr::dvbs2rx::dvb_standard_t standard,
+                                      gr::dvbs2rx::dvb_framesize_t framesize,
+                                      gr::dvbs2rx::dvb_code_rate_t rate)
+{
+    return impl::create(std::move(conn), standard, framesize, rate);
+}
 
-void ldpc_dec_init(LDPCInterface* it) { LdpcDecoder.init(it); }
+LDPCDecoderInterface* ldpc_flooding_dec_create(LDPCInterface* ldpc, int num_threads)
+{
+    return new FloodingDecoder(ldpc, num_threads);
+}
 
-int ldpc_dec_decode(void* buffer, int8_t* code, int trials)
+void pack_hard_decisions(uint8_t* bytes, const int8_t* soft, int len)
 {
-    return LdpcDecoder(buffer, code, trials);
+    impl::pack_hard_decisions(bytes, soft, len);
 }
 
 } // namespace ldpc_generic
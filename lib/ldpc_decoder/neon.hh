@@ -839,4 +839,92 @@ inline SIMD<int32_t, 4> vmax(SIMD<int32_t, 4> a, SIMD<int32_t, 4> b)
     return tmp;
 }
 
+/*
+ * Block transposes between codewords and SIMD lanes, processed in tiles of 16x16
+ * bytes. Four rounds of byte interleaving between rows i and i + 8 rotate the 8-bit
+ * (row, column) index of each byte within the tile by one bit each, so that the
+ * final rows hold the tile's columns.
+ */
+static inline void transpose_16x16(int8x16_t* r)
+{
+    for (int round = 0; round < 4; ++round) {
+        int8x16_t t[16];
+        for (int i = 0; i < 8; ++i) {
+            int8x16x2_t z = vzipq_s8(r[i], r[i + 8]);
+            t[2 * i] = z.val[0];
+            t[2 * i + 1] = z.val[1];
+        }
+        for (int i = 0; i < 16; ++i)
+            r[i] = t[i];
+    }
+}
+
+template <>
+inline void vload_transposed(SIMD<int8_t, 16>* data, const int8_t* const* rows, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        int8x16_t r[16];
+        for (int i = 0; i < 16; ++i)
+            r[i] = vld1q_s8(rows[i] + j);
+        transpose_16x16(r);
+        for (int i = 0; i < 16; ++i)
+            data[j + i].m = r[i];
+    }
+    for (int n = 0; n < 16; ++n)
+        for (int k = j; k < len; ++k)
+            data[k].v[n] = rows[n][k];
+}
+
+template <>
+inline void vstore_transposed(int8_t* const* rows, const SIMD<int8_t, 16>* data, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        int8x16_t r[16];
+        for (int i = 0; i < 16; ++i)
+            r[i] = data[j + i].m;
+        transpose_16x16(r);
+        for (int i = 0; i < 16; ++i)
+            vst1q_s8(rows[i] + j, r[i]);
+    }
+    for (int n = 0; n < 16; ++n)
+        for (int k = j; k < len; ++k)
+            rows[n][k] = data[k].v[n];
+}
+
+// Merge the adjacent bytes of each 16-bit lane, holding BITS bits each, into a single
+// byte, with the first byte on the most significant bits.
+template <int BITS>
+static inline uint8x8_t merge_bit_pairs(uint8x16_t a)
+{
+    uint16x8_t w = vreinterpretq_u16_u8(a);
+    return vmovn_u16(vsraq_n_u16(vshlq_n_u16(w, BITS), w, 8));
+}
+
+template <>
+inline void vpack_signs<int8_t, 16>(uint8_t* bytes, const int8_t* soft, int len)
+{
+    // Extract the sign bits and combine them through three rounds of narrowing shifts,
+    // each doubling the number of bits per byte.
+    int j = 0;
+    for (; j + 64 <= len; j += 64) {
+        const uint8_t* p = (const uint8_t*)(soft + j);
+        uint8x16_t s0 = vshrq_n_u8(vld1q_u8(p), 7);
+        uint8x16_t s1 = vshrq_n_u8(vld1q_u8(p + 16), 7);
+        uint8x16_t s2 = vshrq_n_u8(vld1q_u8(p + 32), 7);
+        uint8x16_t s3 = vshrq_n_u8(vld1q_u8(p + 48), 7);
+        uint8x16_t t0 = vcombine_u8(merge_bit_pairs<1>(s0), merge_bit_pairs<1>(s1));
+        uint8x16_t t1 = vcombine_u8(merge_bit_pairs<1>(s2), merge_bit_pairs<1>(s3));
+        uint8x16_t u = vcombine_u8(merge_bit_pairs<2>(t0), merge_bit_pairs<2>(t1));
+        vst1_u8(bytes + j / 8, merge_bit_pairs<4>(u));
+    }
+    for (; j < len; j += 8) {
+        uint8_t byte = 0;
+        for (int k = 0; k < 8; ++k)
+            byte = (byte << 1) | (soft[j + k] < 0);
+        bytes[j / 8] = byte;
+    }
+}
+
 #endif
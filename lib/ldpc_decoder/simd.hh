@@ -10,9 +10,11 @@
 #ifndef SIMD_HH
 #define SIMD_HH
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 template <typename TYPE, int WIDTH>
 union SIMD;
@@ -1175,6 +1177,135 @@ static inline SIMD<int64_t, WIDTH> vsign(SIMD<int64_t, WIDTH> a, SIMD<int64_t, W
     return tmp;
 }
 
+// Transpose "WIDTH" blocks of "len" elements, one per row pointer, into "len" vectors
+// holding one block per lane, e.g., to decode WIDTH codewords in parallel.
+template <typename TYPE, int WIDTH>
+static inline void
+vload_transposed(SIMD<TYPE, WIDTH>* data, const TYPE* const* rows, int len)
+{
+    for (int n = 0; n < WIDTH; ++n)
+        for (int j = 0; j < len; ++j)
+            data[j].v[n] = rows[n][j];
+}
+
+// Inverse of vload_transposed().
+template <typename TYPE, int WIDTH>
+static inline void
+vstore_transposed(TYPE* const* rows, const SIMD<TYPE, WIDTH>* data, int len)
+{
+    for (int n = 0; n < WIDTH; ++n)
+        for (int j = 0; j < len; ++j)
+            rows[n][j] = data[j].v[n];
+}
+
+// Widening variant of vload_transposed(), from rows of 8-bit elements into wider
+// lanes, with each element scaled up by 2^shift.
+template <typename TYPE, int WIDTH>
+static inline void
+vload_transposed(SIMD<TYPE, WIDTH>* data, const int8_t* const* rows, int len, int shift)
+{
+    for (int j = 0; j < len; ++j)
+        for (int n = 0; n < WIDTH; ++n)
+            data[j].v[n] = TYPE(rows[n][j]) * (TYPE(1) << shift);
+}
+
+// Inverse of the above, scaling each element down by 2^shift (rounding towards minus
+// infinity, which keeps the sign bit of every element) and saturating to 8 bits.
+template <typename TYPE, int WIDTH>
+static inline void
+vstore_transposed(int8_t* const* rows, const SIMD<TYPE, WIDTH>* data, int len, int shift)
+{
+    for (int n = 0; n < WIDTH; ++n)
+        for (int j = 0; j < len; ++j)
+            rows[n][j] = std::min<TYPE>(std::max<TYPE>(data[j].v[n] >> shift, -128), 127);
+}
+
+// Same as above, for "WIDTH" consecutive blocks of "len" elements.
+template <typename TYPE, int WIDTH>
+static inline void vload_transposed(SIMD<TYPE, WIDTH>* data, const TYPE* code, int len)
+{
+    const TYPE* rows[WIDTH];
+    for (int n = 0; n < WIDTH; ++n)
+        rows[n] = code + n * len;
+    vload_transposed(data, rows, len);
+}
+
+template <typename TYPE, int WIDTH>
+static inline void vstore_transposed(TYPE* code, const SIMD<TYPE, WIDTH>* data, int len)
+{
+    TYPE* rows[WIDTH];
+    for (int n = 0; n < WIDTH; ++n)
+        rows[n] = code + n * len;
+    vstore_transposed(rows, data, len);
+}
+
+// Pack the hard decisions of "len" soft values into bytes, MSB first, mapping negative
+// values to bit 1. The length must be a multiple of 8.
+template <typename TYPE, int WIDTH>
+static inline void vpack_signs(uint8_t* bytes, const TYPE* soft, int len)
+{
+    for (int j = 0; j < len; j += 8) {
+        uint8_t byte = 0;
+        for (int k = 0; k < 8; ++k)
+            byte = (byte << 1) | (soft[j + k] < 0);
+        bytes[j / 8] = byte;
+    }
+}
+
+// Pack the hard decisions of "len" vectors holding one block per lane, as given by
+// vload_transposed(), into len / 8 bytes per lane, MSB first, written to one row
+// pointer per lane. The length must be a multiple of 8.
+template <typename TYPE, int WIDTH>
+static inline void
+vpack_signs_transposed(uint8_t* const* rows, const SIMD<TYPE, WIDTH>* soft, int len)
+{
+    for (int n = 0; n < WIDTH; ++n) {
+        for (int j = 0; j < len; j += 8) {
+            uint8_t byte = 0;
+            for (int k = 0; k < 8; ++k)
+                byte = (byte << 1) | (soft[j + k].v[n] < 0);
+            rows[n][j / 8] = byte;
+        }
+    }
+}
+
+// The sign masks of eight consecutive vectors are merged into a vector holding one
+// output byte per lane, and each 16 such vectors are then transposed into 16 bytes of
+// each row at once.
+template <int WIDTH>
+static inline void
+vpack_signs_transposed(uint8_t* const* rows, const SIMD<int8_t, WIDTH>* soft, int len)
+{
+    typedef SIMD<uint8_t, WIDTH> mask_type;
+    mask_type bit[8];
+    for (int k = 0; k < 8; ++k)
+        bit[k] = vreinterpret<mask_type>(vdup<SIMD<int8_t, WIDTH>>(int8_t(0x80 >> k)));
+    const int bytes = len / 8;
+    int b = 0;
+    for (; b + 16 <= bytes; b += 16) {
+        SIMD<int8_t, WIDTH> packed[16];
+        for (int i = 0; i < 16; ++i) {
+            const SIMD<int8_t, WIDTH>* src = soft + 8 * (b + i);
+            mask_type acc = vand(vcltz(src[0]), bit[0]);
+            for (int k = 1; k < 8; ++k)
+                acc = vorr(acc, vand(vcltz(src[k]), bit[k]));
+            packed[i] = vreinterpret<SIMD<int8_t, WIDTH>>(acc);
+        }
+        int8_t* dst[WIDTH];
+        for (int n = 0; n < WIDTH; ++n)
+            dst[n] = reinterpret_cast<int8_t*>(rows[n] + b);
+        vstore_transposed(dst, packed, 16);
+    }
+    for (int n = 0; n < WIDTH; ++n) {
+        for (int j = 8 * b; j < len; j += 8) {
+            uint8_t byte = 0;
+            for (int k = 0; k < 8; ++k)
+                byte = (byte << 1) | (soft[j + k].v[n] < 0);
+            rows[n][j / 8] = byte;
+        }
+    }
+}
+
 #ifdef __AVX2__
 #include "avx2.hh"
 #else
@@ -1183,6 +1314,10 @@ static inline SIMD<int64_t, WIDTH> vsign(SIMD<int64_t, WIDTH> a, SIMD<int64_t, W
 #endif
 #endif
 
+#ifdef __AVX512BW__
+#include "avx512.hh"
+#endif
+
 #if defined(__ARM_NEON__) || defined(__ARM_NEON)
 #include "neon.hh"
 #endif
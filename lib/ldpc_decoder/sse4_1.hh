@@ -967,4 +967,78 @@ inline SIMD<int32_t, 4> vmax(SIMD<int32_t, 4> a, SIMD<int32_t, 4> b)
     return tmp;
 }
 
+/*
+ * Block transposes between codewords and SIMD lanes, processed in tiles of 16x16
+ * bytes. Four rounds of byte interleaving between rows i and i + 8 rotate the 8-bit
+ * (row, column) index of each byte within the tile by one bit each, so that the
+ * final rows hold the tile's columns.
+ */
+static inline void transpose_16x16(__m128i* r)
+{
+    for (int round = 0; round < 4; ++round) {
+        __m128i t[16];
+        for (int i = 0; i < 8; ++i) {
+            t[2 * i] = _mm_unpacklo_epi8(r[i], r[i + 8]);
+            t[2 * i + 1] = _mm_unpackhi_epi8(r[i], r[i + 8]);
+        }
+        for (int i = 0; i < 16; ++i)
+            r[i] = t[i];
+    }
+}
+
+template <>
+inline void vload_transposed(SIMD<int8_t, 16>* data, const int8_t* const* rows, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m128i r[16];
+        for (int i = 0; i < 16; ++i)
+            r[i] = _mm_loadu_si128((const __m128i*)(rows[i] + j));
+        transpose_16x16(r);
+        for (int i = 0; i < 16; ++i)
+            data[j + i].m = r[i];
+    }
+    for (int n = 0; n < 16; ++n)
+        for (int k = j; k < len; ++k)
+            data[k].v[n] = rows[n][k];
+}
+
+template <>
+inline void vstore_transposed(int8_t* const* rows, const SIMD<int8_t, 16>* data, int len)
+{
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m128i r[16];
+        for (int i = 0; i < 16; ++i)
+            r[i] = data[j + i].m;
+        transpose_16x16(r);
+        for (int i = 0; i < 16; ++i)
+            _mm_storeu_si128((__m128i*)(rows[i] + j), r[i]);
+    }
+    for (int n = 0; n < 16; ++n)
+        for (int k = j; k < len; ++k)
+            rows[n][k] = data[k].v[n];
+}
+
+template <>
+inline void vpack_signs<int8_t, 16>(uint8_t* bytes, const int8_t* soft, int len)
+{
+    // Reverse each group of eight bytes so that movemask places the first soft value
+    // of the group on the MSB of the output byte.
+    const __m128i rev =
+        _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    int j = 0;
+    for (; j + 16 <= len; j += 16) {
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(soft + j)), rev);
+        uint16_t mask = _mm_movemask_epi8(a);
+        memcpy(bytes + j / 8, &mask, sizeof(mask));
+    }
+    for (; j < len; j += 8) {
+        uint8_t byte = 0;
+        for (int k = 0; k < 8; ++k)
+            byte = (byte << 1) | (soft[j + k] < 0);
+        bytes[j / 8] = byte;
+    }
+}
+
 #endif
@@ -11,49 +11,25 @@
 #include "config.h"
 #endif
 
-#include "cpu_features_macros.h"
 #include "debug_level.h"
 #include "fec_params.h"
 #include "ldpc_decoder_bb_impl.h"
 #include <gnuradio/io_signature.h>
 #include <gnuradio/logger.h>
-#include <gnuradio/pdu.h>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cmath>
-
-#ifdef CPU_FEATURES_ARCH_ARM
-#include "cpuinfo_arm.h"
-using namespace cpu_features;
-#endif
-
-#ifdef CPU_FEATURES_ARCH_X86
-#include "cpuinfo_x86.h"
-using namespace cpu_features;
-#endif
-
-namespace ldpc_neon {
-void ldpc_dec_init(LDPCInterface* it);
-int ldpc_dec_decode(void* buffer, int8_t* code, int trials);
-} // namespace ldpc_neon
-
-namespace ldpc_avx2 {
-void ldpc_dec_init(LDPCInterface* it);
-int ldpc_dec_decode(void* buffer, int8_t* code, int trials);
-} // namespace ldpc_avx2
-
-namespace ldpc_sse41 {
-void ldpc_dec_init(LDPCInterface* it);
-int ldpc_dec_decode(void* buffer, int8_t* code, int trials);
-} // namespace ldpc_sse41
-
-namespace ldpc_generic {
-void ldpc_dec_init(LDPCInterface* it);
-int ldpc_dec_decode(void* buffer, int8_t* code, int trials);
-} // namespace ldpc_generic
+#include <cstring>
+#include <stdexcept>
+#include <thread>
 
 namespace gr {
 namespace dvbs2rx {
 
+const int DEFAULT_TRIALS = 25;
+
 ldpc_decoder_bb::sptr ldpc_decoder_bb::make(dvb_standard_t standard,
                                             dvb_framesize_t framesize,
                                             dvb_code_rate_t rate,
@@ -61,7 +37,17 @@ ldpc_decoder_bb::sptr ldpc_decoder_bb::make(dvb_standard_t standard,
                                             dvb_outputmode_t outputmode,
                                             dvb_infomode_t infomode,
                                             int max_trials,
-                                            int debug_level)
+                                            int debug_level,
+                                            int num_threads,
+                                            int batch_frames,
+                                            float batch_timeout_ms,
+                                            bool acm_vcm,
+                                            dvb_llr_feedback_t llr_feedback,
+                                            int llr_feedback_interval,
+                                            bool adaptive_trials,
+                                            dvb_ldpc_schedule_t schedule,
+                                            dvb_ldpc_precision_t precision,
+                                            int check_period)
 {
     return gnuradio::get_initial_sptr(new ldpc_decoder_bb_impl(standard,
                                                                framesize,
@@ -70,7 +56,17 @@ ldpc_decoder_bb::sptr ldpc_decoder_bb::make(dvb_standard_t standard,
                                                                outputmode,
                                                                infomode,
                                                                max_trials,
-                                                               debug_level));
+                                                               debug_level,
+                                                               num_threads,
+                                                               batch_frames,
+                                                               batch_timeout_ms,
+                                                               acm_vcm,
+                                                               llr_feedback,
+                                                               llr_feedback_interval,
+                                                               adaptive_trials,
+                                                               schedule,
+                                                               precision,
+                                                               check_period));
 }
 
 /*
@@ -83,16 +79,47 @@ ldpc_decoder_bb_impl::ldpc_decoder_bb_impl(dvb_standard_t standard,
                                            dvb_outputmode_t outputmode,
                                            dvb_infomode_t infomode,
                                            int max_trials,
-                                           int debug_level)
+                                           int debug_level,
+                                           int num_threads,
+                                           int batch_frames,
+                                           float batch_timeout_ms,
+                                           bool acm_vcm,
+                                           dvb_llr_feedback_t llr_feedback,
+                                           int llr_feedback_interval,
+                                           bool adaptive_trials,
+                                           dvb_ldpc_schedule_t schedule,
+                                           dvb_ldpc_precision_t precision,
+                                           int check_period)
     : gr::block("ldpc_decoder_bb",
                 gr::io_signature::make(1, 1, sizeof(int8_t)),
                 gr::io_signature::make(1, 1, sizeof(unsigned char))),
       d_debug_level(debug_level),
+      d_standard(standard),
       d_output_mode(outputmode),
       d_frame_cnt(0),
       d_batch_cnt(0),
       d_total_trials(0),
-      d_max_trials(max_trials)
+      d_max_trials(max_trials),
+      d_num_threads(num_threads),
+      d_batch_frames(batch_frames),
+      d_acm_vcm(acm_vcm),
+      d_discarded(0),
+      d_llr_feedback(llr_feedback),
+      d_llr_feedback_interval(llr_feedback_interval),
+      d_adaptive_trials(adaptive_trials),
+      d_trials_budget(max_trials == 0 ? DEFAULT_TRIALS : max_trials),
+      d_schedule(schedule),
+      d_precision(precision),
+      d_check_period(check_period),
+      d_latency_sum(0),
+      d_latency_cnt(0),
+      d_avg_latency(0),
+      d_iter_hist((max_trials == 0 ? DEFAULT_TRIALS : max_trials) + 1),
+      d_iter_sum(0),
+      d_iter_frames(0),
+      d_max_iter_cnt(0),
+      d_decode_ms_sum(0),
+      d_decode_cnt(0)
 {
     fec_info_t fec_info;
     get_fec_info(standard, framesize, rate, fec_info);
@@ -101,286 +128,237 @@ ldpc_decoder_bb_impl::ldpc_decoder_bb_impl(dvb_standard_t standard,
     d_kldpc_bytes = d_kldpc / 8;
     d_nldpc_bytes = d_nldpc / 8;
 
-    if (framesize == FECFRAME_NORMAL) {
-        switch (rate) {
-        case C1_4:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B1>();
-            break;
-        case C1_3:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B2>();
-            break;
-        case C2_5:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B3>();
-            break;
-        case C1_2:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B4>();
-            break;
-        case C3_5:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B5>();
-            break;
-        case C2_3:
-            if (standard == STANDARD_DVBS2) {
-                d_ldpc = new LDPC<DVB_S2_TABLE_B6>();
-            } else {
-                d_ldpc = new LDPC<DVB_T2_TABLE_A3>();
-            }
-            break;
-        case C3_4:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B7>();
-            break;
-        case C4_5:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B8>();
-            break;
-        case C5_6:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B9>();
-            break;
-        case C8_9:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B10>();
-            break;
-        case C9_10:
-            d_ldpc = new LDPC<DVB_S2_TABLE_B11>();
-            break;
-        case C2_9_VLSNR:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B1>();
-            break;
-        case C13_45:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B2>();
-            break;
-        case C9_20:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B3>();
-            break;
-        case C90_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B11>();
-            break;
-        case C96_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B12>();
-            break;
-        case C11_20:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B4>();
-            break;
-        case C100_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B13>();
-            break;
-        case C104_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B14>();
-            break;
-        case C26_45:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B5>();
-            break;
-        case C18_30:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B22>();
-            break;
-        case C28_45:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B6>();
-            break;
-        case C23_36:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B7>();
-            break;
-        case C116_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B15>();
-            break;
-        case C20_30:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B23>();
-            break;
-        case C124_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B16>();
-            break;
-        case C25_36:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B8>();
-            break;
-        case C128_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B17>();
-            break;
-        case C13_18:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B9>();
-            break;
-        case C132_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B18>();
-            break;
-        case C22_30:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B24>();
-            break;
-        case C135_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B19>();
-            break;
-        case C140_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B20>();
-            break;
-        case C7_9:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B10>();
-            break;
-        case C154_180:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_B21>();
-            break;
-        default:
-            break;
-        }
-    } else if (framesize == FECFRAME_SHORT) {
-        switch (rate) {
-        case C1_4:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C1>();
-            break;
-        case C1_3:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C2>();
-            break;
-        case C2_5:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C3>();
-            break;
-        case C1_2:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C4>();
-            break;
-        case C3_5:
-            if (standard == STANDARD_DVBS2) {
-                d_ldpc = new LDPC<DVB_S2_TABLE_C5>();
-            } else {
-                d_ldpc = new LDPC<DVB_T2_TABLE_B3>();
-            }
-            break;
-        case C2_3:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C6>();
-            break;
-        case C3_4:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C7>();
-            break;
-        case C4_5:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C8>();
-            break;
-        case C5_6:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C9>();
-            break;
-        case C8_9:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C10>();
-            break;
-        case C11_45:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C1>();
-            break;
-        case C4_15:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C2>();
-            break;
-        case C14_45:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C3>();
-            break;
-        case C7_15:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C4>();
-            break;
-        case C8_15:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C5>();
-            break;
-        case C26_45:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C6>();
-            break;
-        case C32_45:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C7>();
-            break;
-        case C1_5_VLSNR_SF2:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C1>();
-            break;
-        case C11_45_VLSNR_SF2:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C1>();
-            break;
-        case C1_5_VLSNR:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C1>();
-            break;
-        case C4_15_VLSNR:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C2>();
-            break;
-        case C1_3_VLSNR:
-            d_ldpc = new LDPC<DVB_S2_TABLE_C2>();
-            break;
-        default:
-            break;
-        }
-    } else {
-        switch (rate) {
-        case C1_5_MEDIUM:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C8>();
-            break;
-        case C11_45_MEDIUM:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C9>();
-            break;
-        case C1_3_MEDIUM:
-            d_ldpc = new LDPC<DVB_S2X_TABLE_C10>();
-            break;
-        default:
-            break;
-        }
+    if (num_threads < 1) {
+        throw std::invalid_argument("The number of decoding threads must be positive");
     }
-
-    decode = nullptr;
-    std::string impl = "generic";
-#ifdef CPU_FEATURES_ARCH_ANY_ARM
-    d_simd_size = 16;
-#ifdef CPU_FEATURES_ARCH_AARCH64
-    const bool has_neon = true; // always available on aarch64
-#else
-    const ArmFeatures features = GetArmInfo().features;
-    const bool has_neon = features.neon;
-#endif
-    if (has_neon) {
-        ldpc_neon::ldpc_dec_init(d_ldpc);
-        decode = &ldpc_neon::ldpc_dec_decode;
-        impl = "neon";
-    } else {
-        ldpc_generic::ldpc_dec_init(d_ldpc);
-        decode = &ldpc_generic::ldpc_dec_decode;
+    // Latency/throughput trade-off: by default, wait for a full SIMD batch of frames
+    // before decoding. Optionally, decode a partial batch once a given number of frames
+    // is available or once the first frame in the batch has waited for a given time.
+    // Conversely, batches longer than the SIMD size are decoded with rolling lanes.
+    if (batch_frames < 0 || batch_timeout_ms < 0) {
+        throw std::invalid_argument("Invalid LDPC batch frame count or timeout");
     }
-#else
-#ifdef CPU_FEATURES_ARCH_X86
-    const X86Features features = GetX86Info().features;
-    d_simd_size = features.avx2 ? 32 : 16;
-    if (features.avx2) {
-        ldpc_avx2::ldpc_dec_init(d_ldpc);
-        decode = &ldpc_avx2::ldpc_dec_decode;
-        impl = "avx2";
-    } else if (features.sse4_1) {
-        ldpc_sse41::ldpc_dec_init(d_ldpc);
-        decode = &ldpc_sse41::ldpc_dec_decode;
-        impl = "sse4_1";
-    } else {
-        ldpc_generic::ldpc_dec_init(d_ldpc);
-        decode = &ldpc_generic::ldpc_dec_decode;
+    if (acm_vcm && standard != STANDARD_DVBS2) {
+        throw std::invalid_argument("ACM/VCM mode is only supported with DVB-S2");
     }
-#else
-    // Not ARM, nor x86. Use generic implementation.
-    d_simd_size = 16;
-    ldpc_generic::ldpc_dec_init(d_ldpc);
-    decode = &ldpc_generic::ldpc_dec_decode;
-#endif
-#endif
-    assert(decode != nullptr);
-    d_debug_logger->debug("LDPC decoder implementation: {:s}", impl);
-    d_soft = new int8_t[d_ldpc->code_len() * d_simd_size];
-    d_aligned_buffer = aligned_alloc(d_simd_size, d_simd_size * d_ldpc->code_len());
+    if (llr_feedback_interval < 1) {
+        throw std::invalid_argument("The LLR feedback interval must be positive");
+    }
+    if (check_period < 1) {
+        throw std::invalid_argument("The convergence check period must be positive");
+    }
+    d_batch_timeout = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float, std::milli>(batch_timeout_ms));
+    d_ccm_code = get_code(framesize, rate);
+    d_debug_logger->debug("LDPC decoder implementation: {:s}",
+                          d_ccm_code->pool->impl());
+    d_debug_logger->debug("LDPC decoding threads: {:d}", num_threads);
+    d_debug_logger->debug("LDPC decoding schedule: {:s}",
+                          schedule == LDPC_SCHEDULE_FLOODING ? "flooding" : "layered");
+    const ldpc_cache_stats_t cache_stats = get_ldpc_cache_stats();
+    d_debug_logger->debug("LDPC connectivity cache: {:d} hits, {:d} misses, {:d} bytes",
+                          cache_stats.hits,
+                          cache_stats.misses,
+                          cache_stats.bytes);
+    if (d_ccm_code->pool->batch_size() > d_ccm_code->pool->simd_size()) {
+        d_debug_logger->debug("LDPC rolling-lane batches of {:d} frames",
+                              d_ccm_code->pool->batch_size());
+    }
+
+    // The output is produced frame by frame, given that batches can be partial. In
+    // ACM/VCM mode, the frame length varies, so the output is checked frame by frame.
     if (outputmode == OM_MESSAGE) {
-        set_output_multiple(d_kldpc_bytes * d_simd_size);
+        if (!acm_vcm)
+            set_output_multiple(d_kldpc_bytes);
         set_relative_rate((double)d_kldpc_bytes / d_nldpc);
     } else {
-        set_output_multiple(d_nldpc_bytes * d_simd_size);
+        if (!acm_vcm)
+            set_output_multiple(d_nldpc_bytes);
         set_relative_rate((double)d_nldpc_bytes / d_nldpc);
     }
 
+    // In ACM/VCM mode, each output frame is tagged explicitly with its MODCOD
+    if (acm_vcm) {
+        set_tag_propagation_policy(TPP_DONT);
+    }
+
     // Settings for LLR PDU port
     d_pdu_meta = pmt::make_dict();
-    d_pdu_meta =
-        pmt::dict_add(d_pdu_meta, pmt::mp("simd_size"), pmt::from_long(d_simd_size));
+    d_pdu_meta = pmt::dict_add(d_pdu_meta,
+                               pmt::mp("simd_size"),
+                               pmt::from_long(d_ccm_code->pool->simd_size()));
     d_pdu_meta = pmt::dict_add(d_pdu_meta, pmt::mp("frame_cnt"), pmt::from_uint64(0));
+    d_pdu_meta = pmt::dict_add(
+        d_pdu_meta, pmt::mp("packed"), pmt::from_bool(llr_feedback == LLR_FEEDBACK_HARD));
     message_port_register_out(d_pdu_port_id);
 }
 
 /*
  * Our virtual destructor.
  */
-ldpc_decoder_bb_impl::~ldpc_decoder_bb_impl()
+ldpc_decoder_bb_impl::~ldpc_decoder_bb_impl() {}
+
+pmt::pmt_t ldpc_decoder_bb_impl::get_pdu_buffer(size_t len)
+{
+    // A vector referenced by the pool only is no longer held by any message in flight.
+    // The fence orders its reuse after the release of the last reference elsewhere.
+    pmt::pmt_t* free_buffer = nullptr;
+    for (auto& buffer : d_pdu_buffers) {
+        if (buffer.use_count() != 1)
+            continue;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (pmt::length(buffer) == len)
+            return buffer;
+        free_buffer = &buffer;
+    }
+
+    // No reusable vector of this length (e.g., on a partial batch or a new MODCOD).
+    // Grow the pool up to its maximum size before replacing vectors of other lengths.
+    pmt::pmt_t buffer = pmt::make_u8vector(len, 0);
+    if (d_pdu_buffers.size() < max_pdu_buffers)
+        d_pdu_buffers.push_back(buffer);
+    else if (free_buffer != nullptr)
+        *free_buffer = buffer;
+    return buffer;
+}
+
+void ldpc_decoder_bb_impl::publish_llrs(const ldpc_code_ctx_t* code,
+                                        const ldpc_batch_t* batch)
+{
+    const int n_llrs = code->nldpc * batch->n_frames;
+    const bool packed = d_llr_feedback == LLR_FEEDBACK_HARD;
+    pmt::pmt_t vec = get_pdu_buffer(packed ? n_llrs / 8 : n_llrs);
+    size_t len;
+    uint8_t* p_vec = pmt::u8vector_writable_elements(vec, len);
+    if (packed)
+        memcpy(p_vec, batch->packed.data(), len);
+    else
+        memcpy(p_vec, batch->llr.data(), len);
+    d_pdu_meta = pmt::dict_add(
+        d_pdu_meta, pmt::mp("simd_size"), pmt::from_long(batch->n_frames));
+    d_pdu_meta = pmt::dict_add(
+        d_pdu_meta, pmt::mp("frame_cnt"), pmt::from_uint64(batch->frame_cnt));
+    d_pdu_meta = pmt::dict_add(
+        d_pdu_meta,
+        pmt::mp("frame_idx"),
+        pmt::init_u64vector(batch->n_frames, batch->frame_idx.data()));
+    message_port_pub(d_pdu_port_id, pmt::cons(d_pdu_meta, vec));
+}
+
+void ldpc_decoder_bb_impl::update_stats(const ldpc_batch_t* batch)
+{
+    std::lock_guard<std::mutex> lock(d_stats_mutex);
+    for (int i = 0; i < batch->n_frames; i++) {
+        const int result = batch->results[i];
+        const int iterations = (result < 0) ? batch->trials : batch->trials - result;
+        d_iter_hist[iterations]++;
+        d_iter_sum += iterations;
+        if (result < 0)
+            d_max_iter_cnt++;
+    }
+    d_iter_frames += batch->n_frames;
+    d_decode_ms_sum += batch->decode_ms;
+    d_decode_cnt++;
+}
+
+float ldpc_decoder_bb_impl::get_average_iterations()
+{
+    std::lock_guard<std::mutex> lock(d_stats_mutex);
+    return d_iter_frames ? (float)d_iter_sum / d_iter_frames : 0;
+}
+
+std::vector<uint64_t> ldpc_decoder_bb_impl::get_iteration_histogram()
+{
+    std::lock_guard<std::mutex> lock(d_stats_mutex);
+    return d_iter_hist;
+}
+
+uint64_t ldpc_decoder_bb_impl::get_max_iteration_count()
+{
+    std::lock_guard<std::mutex> lock(d_stats_mutex);
+    return d_max_iter_cnt;
+}
+
+float ldpc_decoder_bb_impl::get_average_decode_time()
+{
+    std::lock_guard<std::mutex> lock(d_stats_mutex);
+    return d_decode_cnt ? d_decode_ms_sum / d_decode_cnt : 0;
+}
+
+ldpc_code_ctx_t* ldpc_decoder_bb_impl::get_code(dvb_framesize_t framesize,
+                                                dvb_code_rate_t rate)
+{
+    auto it = d_codes.find(code_key_t(framesize, rate));
+    if (it != d_codes.end())
+        return &it->second;
+
+    auto pool = std::make_unique<ldpc_decoder_pool>(d_standard,
+                                                    framesize,
+                                                    rate,
+                                                    d_num_threads,
+                                                    d_batch_frames,
+                                                    d_schedule,
+                                                    d_precision);
+    fec_info_t fec_info;
+    get_fec_info(d_standard, framesize, rate, fec_info);
+    ldpc_code_ctx_t& code = d_codes[code_key_t(framesize, rate)];
+    // The decoded LLRs are only needed for the soft LLR feedback
+    pool->set_soft_output(d_llr_feedback == LLR_FEEDBACK_SOFT);
+    pool->set_check_period(d_check_period);
+    code.pool = std::move(pool);
+    code.nldpc = fec_info.ldpc.n;
+    code.kldpc = fec_info.ldpc.k;
+    code.staged = nullptr;
+    code.tag_value = pmt::PMT_NIL;
+    if (d_adaptive_trials) {
+        code.budget = std::make_unique<ldpc_trials_budget>(
+            (d_max_trials == 0) ? DEFAULT_TRIALS : d_max_trials);
+    }
+    return &code;
+}
+
+ldpc_code_ctx_t* ldpc_decoder_bb_impl::get_tagged_code(const pmt::pmt_t& value)
 {
-    free(d_aligned_buffer);
-    delete[] d_soft;
-    delete d_ldpc;
+    if (!pmt::is_pair(value) || !pmt::is_integer(pmt::car(value)) ||
+        !pmt::is_bool(pmt::cdr(value)))
+        return nullptr;
+    const long modcod = pmt::to_long(pmt::car(value));
+    const bool short_fecframe = pmt::to_bool(pmt::cdr(value));
+    dvb_framesize_t framesize;
+    dvb_code_rate_t rate;
+    // Check the range before narrowing the MODCOD into the 8-bit argument below
+    if (modcod < 1 || modcod > MAX_MODCOD ||
+        !get_modcod_fec(static_cast<uint8_t>(modcod), short_fecframe, framesize, rate))
+        return nullptr;
+    ldpc_code_ctx_t* code = get_code(framesize, rate);
+    if (pmt::is_null(code->tag_value)) {
+        code->tag_value = value;
+        GR_LOG_DEBUG_LEVEL(1,
+                           "New MODCOD {:d} ({:s} FECFRAME)",
+                           modcod,
+                           short_fecframe ? "short" : "normal");
+    }
+    return code;
 }
 
 void ldpc_decoder_bb_impl::forecast(int noutput_items,
                                     gr_vector_int& ninput_items_required)
 {
-    if (d_output_mode == OM_MESSAGE) {
+    // Batches still being decoded can be output without any new input. Also, a staged
+    // partial batch may have to be flushed on timeout without any new input.
+    bool any_staged = false;
+    for (const auto& code : d_codes)
+        any_staged |= code.second.staged != nullptr;
+    if (head_submitted() || (any_staged && d_batch_timeout.count() > 0)) {
+        ninput_items_required[0] = 0;
+        return;
+    }
+
+    if (d_acm_vcm) {
+        // The frame length is unknown until the frame's tag is read. Wait for at least
+        // the shortest FECFRAME.
+        ninput_items_required[0] = 16200;
+    } else if (d_output_mode == OM_MESSAGE) {
         unsigned int n_frames = noutput_items / d_kldpc_bytes;
         ninput_items_required[0] = n_frames * d_nldpc;
     } else {
@@ -388,9 +366,14 @@ void ldpc_decoder_bb_impl::forecast(int noutput_items,
     }
 }
 
-const int DEFAULT_TRIALS = 25;
 #define FACTOR 2 // same factor used on the decoder implementation
 
+void ldpc_decoder_bb_impl::submit_staged_batch(ldpc_code_ctx_t* code)
+{
+    code->pool->submit(code->staged);
+    code->staged = nullptr;
+}
+
 int ldpc_decoder_bb_impl::general_work(int noutput_items,
                                        gr_vector_int& ninput_items,
                                        gr_vector_const_void_star& input_items,
@@ -398,52 +381,211 @@ int ldpc_decoder_bb_impl::general_work(int noutput_items,
 {
     const int8_t* in = (const int8_t*)input_items[0];
     unsigned char* out = (unsigned char*)output_items[0];
-    const int CODE_LEN = d_ldpc->code_len();
     const int trials = (d_max_trials == 0) ? DEFAULT_TRIALS : d_max_trials;
-    int consumed = 0;
-    int output_size = d_output_mode ? d_kldpc_bytes : d_nldpc_bytes;
-
-    for (int i = 0; i < noutput_items; i += output_size * d_simd_size) {
-        memcpy(d_soft, in + consumed, d_nldpc * d_simd_size * sizeof(int8_t));
-
-        // LDPC Decoding
-        int count = decode(d_aligned_buffer, d_soft, trials);
-        if (count < 0) {
-            d_total_trials += trials;
-            GR_LOG_DEBUG_LEVEL(
-                1, "frame = {:d}, trials = {:d} (max)", d_frame_cnt, trials);
-        } else {
-            d_total_trials += (trials - count);
-            GR_LOG_DEBUG_LEVEL(
-                1, "frame = {:d}, trials = {:d}", d_frame_cnt, (trials - count));
+    const int n_input = ninput_items[0];
+    const auto arrival = std::chrono::steady_clock::now();
+    int consumed = 0; // consumed input items (LLRs)
+    int produced = 0; // produced output items (bytes)
+
+    // In ACM/VCM mode, the XFECFRAME tags mark the start of each frame and its code
+    std::vector<tag_t> tags;
+    if (d_acm_vcm) {
+        get_tags_in_window(tags, 0, 0, n_input, d_xfecframe_tag_key);
+        std::sort(tags.begin(), tags.end(), tag_t::offset_compare);
+    }
+    auto tag = tags.begin();
+
+    while (true) {
+        // Stage the incoming frames into the batch being filled for their code, and
+        // submit the batch for decoding once it has enough frames.
+        bool blocked = false;
+        while (consumed < n_input) {
+            ldpc_code_ctx_t* code = d_ccm_code;
+            if (d_acm_vcm) {
+                const uint64_t offset = nitems_read(0) + consumed;
+                while (tag != tags.end() && tag->offset < offset)
+                    tag++;
+                auto next_tag = (tag == tags.end()) ? tag : std::next(tag);
+                code = (tag != tags.end() && tag->offset == offset)
+                           ? get_tagged_code(tag->value)
+                           : nullptr;
+                // Discard the input up to the next tag if there is no valid frame
+                // starting here, or if the next tag interrupts the frame
+                if (code != nullptr && next_tag != tags.end() &&
+                    next_tag->offset < offset + code->nldpc)
+                    code = nullptr;
+                if (code == nullptr) {
+                    auto skip_end = (tag != tags.end() && tag->offset > offset)
+                                        ? tag
+                                        : next_tag;
+                    const int n_skip = (skip_end == tags.end())
+                                           ? (n_input - consumed)
+                                           : (skip_end->offset - offset);
+                    GR_LOG_DEBUG_LEVEL(
+                        2, "Discarding {:d} LLRs without a valid frame tag", n_skip);
+                    d_discarded += n_skip;
+                    consumed += n_skip;
+                    continue;
+                }
+            }
+            if (n_input - consumed < (int)code->nldpc)
+                break; // wait for the full frame
+
+            if (code->staged == nullptr) {
+                code->staged = code->pool->acquire();
+                if (code->staged == nullptr) {
+                    blocked = true; // all batch buffers of this code in use
+                    break;
+                }
+                code->staged->frame_cnt = d_frame_cnt;
+                code->staged->n_frames = 0;
+                code->staged->trials = code->budget ? code->budget->budget() : trials;
+                code->deadline = std::chrono::steady_clock::now() + d_batch_timeout;
+            }
+            // Decode the frame straight from the input buffer, unless the batch remains
+            // staged at the end of this call (see the detach() calls below)
+            ldpc_batch_t* batch = code->staged;
+            batch->frames[batch->n_frames] = in + consumed;
+            // In ACM/VCM mode, the frames of a batch are not necessarily contiguous
+            batch->frame_idx[batch->n_frames] = d_frame_cnt;
+            // Keep the channel LLRs of the first frame for the post-decoder SNR
+            if (code->budget && batch->n_frames == 0)
+                batch->ref_llr.assign(in + consumed, in + consumed + code->nldpc);
+            d_frames.push_back({ code, batch, batch->n_frames, arrival });
+            batch->n_frames++;
+            consumed += code->nldpc;
+            d_frame_cnt++;
+            if (batch->n_frames == code->pool->batch_size())
+                submit_staged_batch(code);
         }
 
-        // Send decoded LLRs so that the XFECFRAME demapper can refine its SNR estimate
-        d_pdu_meta = pmt::dict_add(
-            d_pdu_meta, pmt::mp("frame_cnt"), pmt::from_uint64(d_frame_cnt));
-        message_port_pub(
-            d_pdu_port_id,
-            pmt::cons(d_pdu_meta,
-                      pdu::make_pdu_vector(types::byte_t,
-                                           reinterpret_cast<const uint8_t*>(d_soft),
-                                           d_nldpc * d_simd_size)));
+        // Flush the partially filled batches whose deadline has expired
+        if (d_batch_timeout.count() > 0) {
+            const auto now = std::chrono::steady_clock::now();
+            for (auto& entry : d_codes) {
+                ldpc_code_ctx_t* code = &entry.second;
+                if (code->staged != nullptr && now >= code->deadline)
+                    submit_staged_batch(code);
+            }
+        }
 
-        // Output bit-packed bytes with the hard decisions and with the MSB first
-        for (int blk = 0; blk < d_simd_size; blk++) {
-            for (int j = 0; j < output_size; j++) {
-                *out = 0;
-                for (int k = 0; k < 8; k++) {
-                    if (d_soft[(j * 8) + k + (blk * CODE_LEN)] < 0) {
-                        *out |= 1 << (7 - k);
-                    }
+        // In ACM/VCM mode, the oldest frame may be waiting in a partial batch while
+        // the buffers of another code are all taken by frames queued behind it. Flush
+        // the partial batch so that the output order can progress.
+        if (blocked && !d_frames.empty() && !head_submitted())
+            submit_staged_batch(d_frames.front().ctx);
+
+        if (!head_submitted())
+            break;
+
+        // Retire the decoded frames in input order. Wait for the oldest batch only if
+        // there was no progress so far, so that each call makes progress while the other
+        // batches remain decoding in the background.
+        const ldpc_frame_ref_t frame = d_frames.front();
+        ldpc_code_ctx_t* code = frame.ctx;
+        const unsigned int output_size =
+            (d_output_mode == OM_MESSAGE) ? code->kldpc / 8 : code->nldpc / 8;
+        if (noutput_items - produced < (int)output_size)
+            break; // no more output space
+        ldpc_batch_t* batch =
+            code->pool->front(/*wait=*/produced == 0 && consumed == 0);
+        if (batch == nullptr)
+            break;
+        assert(batch == frame.batch);
+
+        if (frame.idx == 0) {
+            if (batch->result < 0) {
+                d_total_trials += batch->trials;
+                GR_LOG_DEBUG_LEVEL(1,
+                                   "frame = {:d}, trials = {:d} (max)",
+                                   batch->frame_cnt,
+                                   batch->trials);
+            } else {
+                d_total_trials += (batch->trials - batch->result);
+                GR_LOG_DEBUG_LEVEL(1,
+                                   "frame = {:d}, trials = {:d}",
+                                   batch->frame_cnt,
+                                   (batch->trials - batch->result));
+            }
+            update_stats(batch);
+
+            // Send decoded LLRs so that the XFECFRAME demapper can refine its SNR
+            // estimate. The padded lanes of a partial batch are not included.
+            if (d_llr_feedback != LLR_FEEDBACK_OFF &&
+                d_batch_cnt % d_llr_feedback_interval == 0) {
+                publish_llrs(code, batch);
+            }
+
+            // Adapt the trials budget of the next batches of this code
+            if (code->budget) {
+                for (int i = 0; i < batch->n_frames; i++) {
+                    code->budget->add_frame(batch->trials - batch->results[i],
+                                            batch->results[i] >= 0);
                 }
-                out++;
+                code->budget->add_snr(ldpc_trials_budget::estimate_snr(
+                    batch->ref_llr.data(), batch->packed.data(), code->nldpc));
+                d_trials_budget = code->budget->update();
+                GR_LOG_DEBUG_LEVEL(2,
+                                   "LDPC trials budget = {:d}, SNR = {:.2f} dB",
+                                   (int)d_trials_budget,
+                                   code->budget->snr());
+            }
+        }
+
+        if (d_acm_vcm) {
+            add_item_tag(
+                0, nitems_written(0) + produced, d_xfecframe_tag_key, code->tag_value);
+        }
+
+        // Tag the frame with its convergence status and number of iterations so that
+        // the BCH decoder can skip the frames whose parity checks are all satisfied
+        const int result = batch->results[frame.idx];
+        const int iterations = (result < 0) ? batch->trials : batch->trials - result;
+        add_item_tag(0,
+                     nitems_written(0) + produced,
+                     d_ldpc_status_tag_key,
+                     pmt::cons(pmt::from_bool(result >= 0), pmt::from_long(iterations)));
+
+        // Output bit-packed bytes with the hard decisions and with the MSB first
+        memcpy(out, batch->packed.data() + frame.idx * code->nldpc / 8, output_size);
+        out += output_size;
+        produced += output_size;
+        d_frames.pop_front();
+
+        const std::chrono::duration<double, std::milli> latency =
+            std::chrono::steady_clock::now() - frame.arrival;
+        d_latency_sum += latency.count();
+        d_latency_cnt++;
+        d_avg_latency = d_latency_sum / d_latency_cnt;
+        GR_LOG_DEBUG_LEVEL(2,
+                           "frame = {:d}, latency = {:.3f} ms",
+                           batch->frame_idx[frame.idx],
+                           latency.count());
+
+        if (frame.idx == batch->n_frames - 1) {
+            d_batch_cnt++;
+            code->pool->release();
+        }
+    }
+
+    // Wait a little before checking the deadlines again if nothing else can be done
+    if (consumed == 0 && produced == 0 && d_batch_timeout.count() > 0) {
+        auto wakeup = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+        bool any_staged = false;
+        for (const auto& entry : d_codes) {
+            if (entry.second.staged != nullptr) {
+                any_staged = true;
+                wakeup = std::min(wakeup, entry.second.deadline);
             }
         }
+        if (any_staged)
+            std::this_thread::sleep_until(wakeup);
+    }
 
-        consumed += d_nldpc * d_simd_size;
-        d_frame_cnt += d_simd_size;
-        d_batch_cnt++;
+    // The staged batches cannot reference the input buffer beyond this call
+    for (auto& entry : d_codes) {
+        if (entry.second.staged != nullptr)
+            entry.second.pool->detach(entry.second.staged);
     }
 
     // Tell runtime system how many input items we consumed on
@@ -451,7 +593,7 @@ int ldpc_decoder_bb_impl::general_work(int noutput_items,
     consume_each(consumed);
 
     // Tell runtime system how many output items we produced.
-    return noutput_items;
+    return produced;
 }
 
 } /* namespace dvbs2rx */
@@ -12,19 +12,50 @@
 
 
 #include "dvb_defines.h"
-#include "dvb_s2_tables.hh"
-#include "dvb_s2x_tables.hh"
-#include "dvb_t2_tables.hh"
-#include "ldpc_decoder/ldpc.hh"
+#include "ldpc_decoder_pool.h"
+#include "ldpc_trials_budget.h"
 #include <gnuradio/dvbs2rx/ldpc_decoder_bb.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace gr {
 namespace dvbs2rx {
 
+/**
+ * @brief Decoding context of one LDPC code (one MODCOD in ACM/VCM mode).
+ */
+struct ldpc_code_ctx_t {
+    std::unique_ptr<ldpc_decoder_pool> pool; /**< Pool of decoders for this code */
+    unsigned int nldpc;                      /**< Codeword length in bits */
+    unsigned int kldpc;                      /**< Message length in bits */
+    ldpc_batch_t* staged; /**< Batch being filled with input frames */
+    std::chrono::steady_clock::time_point deadline; /**< Staged batch deadline */
+    pmt::pmt_t tag_value; /**< XFECFRAME tag value (ACM/VCM mode only) */
+    std::unique_ptr<ldpc_trials_budget> budget; /**< Adaptive trials budget, if any */
+};
+
+/**
+ * @brief Reference to a frame staged or decoded in a batch, pending output.
+ */
+struct ldpc_frame_ref_t {
+    ldpc_code_ctx_t* ctx; /**< Code of the frame */
+    ldpc_batch_t* batch;  /**< Batch holding the frame */
+    int idx;              /**< Index of the frame within the batch */
+    std::chrono::steady_clock::time_point arrival; /**< Time of the frame's arrival */
+};
+
 class ldpc_decoder_bb_impl : public ldpc_decoder_bb
 {
 private:
+    typedef std::pair<dvb_framesize_t, dvb_code_rate_t> code_key_t;
     const int d_debug_level;     /**< Debug level for logs */
+    dvb_standard_t d_standard;   /**< DVB standard */
     unsigned int d_nldpc;        /**< Codeword length in bits */
     unsigned int d_nldpc_bytes;  /**< Codeword length in bytes */
     unsigned int d_kldpc;        /**< Message length in bits */
@@ -34,13 +65,86 @@ private:
     uint64_t d_batch_cnt;        /**< Frame batch count */
     unsigned int d_total_trials; /**< Total LDPC decoding trials */
     int d_max_trials;            /**< Max decoding trials per frame */
-    LDPCInterface* d_ldpc;
-    int d_simd_size; /**< Number of bytes on the SIMD register */
-    int8_t* d_soft;
-    void* d_aligned_buffer;
-    int (*decode)(void*, int8_t*, int);
+    int d_num_threads;           /**< Decoding threads per code */
+    int d_batch_frames;          /**< Frames that trigger the decoding of a batch */
+    bool d_acm_vcm;              /**< Whether the code is given by the frame tags */
+    std::map<code_key_t, ldpc_code_ctx_t> d_codes; /**< Decoding contexts by code */
+    ldpc_code_ctx_t* d_ccm_code;                   /**< Decoding context in CCM mode */
+    std::deque<ldpc_frame_ref_t> d_frames; /**< Frames pending output, in order */
+    uint64_t d_discarded; /**< Input LLRs discarded in ACM/VCM mode */
+    std::chrono::steady_clock::duration d_batch_timeout; /**< Partial batch timeout */
+    dvb_llr_feedback_t d_llr_feedback; /**< Format of the LLR PDUs */
+    int d_llr_feedback_interval;       /**< Decoded batches per LLR PDU */
+    bool d_adaptive_trials;            /**< Whether the trials budget is adaptive */
+    std::atomic<int> d_trials_budget;  /**< Trials budget of the last batch */
+    dvb_ldpc_schedule_t d_schedule;    /**< Decoding schedule */
+    dvb_ldpc_precision_t d_precision;  /**< Decoder precision (or automatic) */
+    int d_check_period;                /**< Iterations between convergence checks */
+    double d_latency_sum;              /**< Sum of the frame latencies in ms */
+    uint64_t d_latency_cnt;            /**< Number of frames in d_latency_sum */
+    std::atomic<float> d_avg_latency;  /**< Average frame latency in ms */
+    std::mutex d_stats_mutex;          /**< Mutex for the iteration statistics */
+    std::vector<uint64_t> d_iter_hist; /**< Frame count per number of iterations */
+    uint64_t d_iter_sum;               /**< Total iterations of the decoded frames */
+    uint64_t d_iter_frames;            /**< Number of frames in d_iter_sum */
+    uint64_t d_max_iter_cnt;           /**< Frames that did not converge */
+    double d_decode_ms_sum;            /**< Total batch decoding time in ms */
+    uint64_t d_decode_cnt;             /**< Number of batches in d_decode_ms_sum */
+    std::vector<pmt::pmt_t> d_pdu_buffers; /**< Reusable LLR PDU vectors */
+    static constexpr size_t max_pdu_buffers = 8; /**< LLR PDU vector pool size */
     pmt::pmt_t d_pdu_meta;
     const pmt::pmt_t d_pdu_port_id = pmt::mp("llr_pdu");
+    const pmt::pmt_t d_xfecframe_tag_key = pmt::intern("XFECFRAME");
+    const pmt::pmt_t d_ldpc_status_tag_key = pmt::intern("ldpc_status");
+
+    /**
+     * @brief Get the decoding context of a code, creating it on the first use.
+     * @param framesize FECFRAME size.
+     * @param rate LDPC code rate.
+     * @return ldpc_code_ctx_t* Decoding context.
+     */
+    ldpc_code_ctx_t* get_code(dvb_framesize_t framesize, dvb_code_rate_t rate);
+
+    /**
+     * @brief Get the decoding context of the code given by an XFECFRAME tag.
+     * @param value Tag value with the MODCOD and the short FECFRAME flag.
+     * @return ldpc_code_ctx_t* Decoding context, or nullptr if the tag is invalid.
+     */
+    ldpc_code_ctx_t* get_tagged_code(const pmt::pmt_t& value);
+
+    /**
+     * @brief Get a vector for an LLR PDU, reusing a pooled one if possible.
+     *
+     * Each published PDU holds a reference to its vector until all subscribers are
+     * done with the message. Pooled vectors no longer referenced by any message are
+     * overwritten instead of allocating a new vector for every PDU.
+     *
+     * @param len Vector length in bytes.
+     * @return pmt::pmt_t Unsigned byte vector (u8vector) of the given length.
+     */
+    pmt::pmt_t get_pdu_buffer(size_t len);
+
+    /**
+     * @brief Publish the decoded LLRs of a batch on the llr_pdu message port.
+     * @param code Decoding context.
+     * @param batch Decoded batch.
+     */
+    void publish_llrs(const ldpc_code_ctx_t* code, const ldpc_batch_t* batch);
+
+    /**
+     * @brief Record the iterations of each frame and the decoding time of a batch.
+     * @param batch Decoded batch.
+     */
+    void update_stats(const ldpc_batch_t* batch);
+
+    /**
+     * @brief Check whether the oldest frame pending output has been submitted.
+     */
+    bool head_submitted() const
+    {
+        return !d_frames.empty() &&
+               d_frames.front().batch != d_frames.front().ctx->staged;
+    }
 
 public:
     ldpc_decoder_bb_impl(dvb_standard_t standard,
@@ -50,9 +154,25 @@ public:
                          dvb_outputmode_t outputmode,
                          dvb_infomode_t infomode,
                          int max_trials,
-                         int debug_level);
+                         int debug_level,
+                         int num_threads,
+                         int batch_frames,
+                         float batch_timeout_ms,
+                         bool acm_vcm,
+                         dvb_llr_feedback_t llr_feedback,
+                         int llr_feedback_interval,
+                         bool adaptive_trials,
+                         dvb_ldpc_schedule_t schedule,
+                         dvb_ldpc_precision_t precision,
+                         int check_period);
     ~ldpc_decoder_bb_impl();
 
+    /**
+     * @brief Submit the staged batch of frames of a given code for decoding.
+     * @param code Decoding context.
+     */
+    void submit_staged_batch(ldpc_code_ctx_t* code);
+
     void forecast(int noutput_items, gr_vector_int& ninput_items_required);
 
     int general_work(int noutput_items,
@@ -61,6 +181,18 @@ public:
                      gr_vector_void_star& output_items);
 
     unsigned int get_average_trials() { return d_total_trials / d_batch_cnt; }
+
+    int get_trials_budget() { return d_trials_budget; }
+
+    float get_average_latency() { return d_avg_latency; }
+
+    float get_average_iterations();
+
+    std::vector<uint64_t> get_iteration_histogram();
+
+    uint64_t get_max_iteration_count();
+
+    float get_average_decode_time();
 };
 
 } // namespace dvbs2rx
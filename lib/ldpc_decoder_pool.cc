@@ -0,0 +1,212 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "ldpc_decoder_pool.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+
+namespace gr {
+namespace dvbs2rx {
+
+ldpc_decoder_pool::ldpc_decoder_pool(LDPCInterface* ldpc,
+                                     int num_threads,
+                                     int batch_size)
+    : d_num_threads(std::max(num_threads, 1)),
+      d_code_len(ldpc->code_len()),
+      d_soft_output(true),
+      d_stop(false)
+{
+    for (int i = 0; i < d_num_threads; i++)
+        d_decoders.push_back(make_ldpc_decoder(ldpc));
+    init(batch_size);
+}
+
+ldpc_decoder_pool::ldpc_decoder_pool(dvb_standard_t standard,
+                                     dvb_framesize_t framesize,
+                                     dvb_code_rate_t rate,
+                                     int num_threads,
+                                     int batch_size,
+                                     dvb_ldpc_schedule_t schedule,
+                                     dvb_ldpc_precision_t precision)
+    : d_num_threads(std::max(num_threads, 1)), d_soft_output(true), d_stop(false)
+{
+    if (schedule == LDPC_SCHEDULE_FLOODING) {
+        // A single decoder using all threads for each frame
+        auto ldpc = make_ldpc_code(standard, framesize, rate);
+        if (!ldpc)
+            throw std::invalid_argument("Unsupported LDPC code configuration");
+        d_code_len = ldpc->code_len();
+        d_decoders.push_back(make_ldpc_flooding_decoder(ldpc.get(), d_num_threads));
+        d_num_threads = 1;
+        init(batch_size);
+        return;
+    }
+    auto conn = get_ldpc_connectivity(standard, framesize, rate);
+    if (!conn)
+        throw std::invalid_argument("Unsupported LDPC code configuration");
+    d_code_len = conn->N;
+    for (int i = 0; i < d_num_threads; i++)
+        d_decoders.push_back(make_ldpc_decoder(standard, framesize, rate, precision));
+    init(batch_size);
+}
+
+void ldpc_decoder_pool::init(int batch_size)
+{
+    d_batch_size = (batch_size > 0) ? batch_size : simd_size();
+
+    // Twice as many batch buffers as decoders so that the producer can fill and retire
+    // batches while all decoders are busy.
+    const int n_slots = (d_num_threads == 1) ? 1 : (2 * d_num_threads);
+    const int batch_frames = std::max(d_batch_size, simd_size());
+    d_slots.resize(n_slots);
+    for (auto& batch : d_slots) {
+        batch.llr.resize(d_code_len * batch_frames);
+        batch.frames.resize(batch_frames);
+        batch.frame_idx.resize(batch_frames);
+        batch.packed.resize(d_code_len / 8 * batch_frames);
+        batch.results.resize(batch_frames);
+        d_free.push_back(&batch);
+    }
+
+    if (d_num_threads > 1) {
+        for (auto& decoder : d_decoders)
+            d_workers.emplace_back(&ldpc_decoder_pool::worker, this, decoder.get());
+    }
+}
+
+ldpc_decoder_pool::~ldpc_decoder_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_job_cv.notify_all();
+    for (auto& thread : d_workers)
+        thread.join();
+}
+
+void ldpc_decoder_pool::worker(LDPCDecoderInterface* decoder)
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (true) {
+        d_job_cv.wait(lock, [this] { return d_stop || !d_jobs.empty(); });
+        if (d_stop)
+            return;
+        ldpc_batch_t* batch = d_jobs.front();
+        d_jobs.pop_front();
+        lock.unlock();
+        decode(decoder, batch);
+        lock.lock();
+        batch->done = true;
+        d_done_cv.notify_one();
+    }
+}
+
+void ldpc_decoder_pool::decode(LDPCDecoderInterface* decoder, ldpc_batch_t* batch)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // Frames not referenced elsewhere are read from the batch's own buffer
+    for (int i = 0; i < batch->n_frames; i++) {
+        if (batch->frames[i] == nullptr)
+            batch->frames[i] = batch->llr.data() + i * d_code_len;
+    }
+
+    auto results_end = batch->results.begin() + batch->n_frames;
+    if (d_batch_size > simd_size()) {
+        decoder->decode_rolling(batch->frames.data(),
+                                batch->llr.data(),
+                                batch->n_frames,
+                                batch->results.data(),
+                                batch->trials);
+        batch->result = *std::min_element(batch->results.begin(), results_end);
+        ldpc_pack_hard_decisions(
+            batch->packed.data(), batch->llr.data(), batch->n_frames * d_code_len);
+    } else {
+        // The unused lanes (nullptr frames) are padded with the all-zero codeword
+        batch->result = decoder->decode(
+            batch->frames.data(), batch->results.data(), batch->trials);
+        decoder->pack(batch->packed.data(), d_code_len);
+        if (d_soft_output)
+            decoder->store(batch->llr.data());
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    batch->decode_ms = elapsed.count();
+}
+
+void ldpc_decoder_pool::set_check_period(int period)
+{
+    for (auto& decoder : d_decoders)
+        decoder->set_check_period(period);
+}
+
+ldpc_batch_t* ldpc_decoder_pool::acquire()
+{
+    if (d_free.empty())
+        return nullptr;
+    ldpc_batch_t* batch = d_free.back();
+    d_free.pop_back();
+    std::fill(batch->frames.begin(), batch->frames.end(), nullptr);
+    return batch;
+}
+
+void ldpc_decoder_pool::detach(ldpc_batch_t* batch)
+{
+    for (int i = 0; i < batch->n_frames; i++) {
+        if (batch->frames[i] == nullptr)
+            continue;
+        std::copy_n(batch->frames[i], d_code_len, batch->llr.begin() + i * d_code_len);
+        batch->frames[i] = nullptr;
+    }
+}
+
+void ldpc_decoder_pool::submit(ldpc_batch_t* batch)
+{
+    assert(batch->n_frames > 0 && batch->n_frames <= d_batch_size);
+    batch->done = false;
+    d_inflight.push_back(batch);
+    if (d_num_threads == 1) {
+        decode(d_decoders[0].get(), batch);
+        batch->done = true;
+        return;
+    }
+    detach(batch);
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_jobs.push_back(batch);
+    }
+    d_job_cv.notify_one();
+}
+
+ldpc_batch_t* ldpc_decoder_pool::front(bool wait)
+{
+    if (d_inflight.empty())
+        return nullptr;
+    ldpc_batch_t* batch = d_inflight.front();
+    if (d_num_threads == 1)
+        return batch;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    if (wait)
+        d_done_cv.wait(lock, [batch] { return batch->done; });
+    return batch->done ? batch : nullptr;
+}
+
+void ldpc_decoder_pool::release()
+{
+    assert(!d_inflight.empty());
+    d_free.push_back(d_inflight.front());
+    d_inflight.pop_front();
+}
+
+} // namespace dvbs2rx
+} // namespace gr
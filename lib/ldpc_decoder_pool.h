@@ -0,0 +1,237 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DVBS2RX_LDPC_DECODER_POOL_H
+#define INCLUDED_DVBS2RX_LDPC_DECODER_POOL_H
+
+#include "ldpc_backend.h"
+#include <gnuradio/dvbs2rx/api.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace dvbs2rx {
+
+/**
+ * @brief Batch of LDPC codewords decoded together on the SIMD lanes of a decoder.
+ */
+struct ldpc_batch_t {
+    std::vector<int8_t> llr;           /**< Input LLRs, replaced by the decoded LLRs */
+    std::vector<const int8_t*> frames; /**< Input LLRs held elsewhere (or nullptr) */
+    std::vector<uint8_t> packed;       /**< Hard decisions, N / 8 bytes per frame */
+    uint64_t frame_cnt;                /**< Index of the first frame in the batch */
+    std::vector<uint64_t> frame_idx;   /**< Stream index of each frame */
+    int n_frames;                      /**< Number of frames filled into the batch */
+    int trials;                        /**< Maximum number of decoding trials */
+    int result;                        /**< Decoder return value (remaining trials) */
+    std::vector<int> results;          /**< Remaining trials of each frame */
+    double decode_ms;                  /**< Decoding time in milliseconds */
+    std::vector<int8_t> ref_llr;       /**< Copy of the first frame's input LLRs */
+    bool done;                         /**< Whether the batch has been decoded already */
+};
+
+/**
+ * @brief Pool of LDPC decoders processing batches in parallel with in-order retiring.
+ *
+ * Batches are acquired from a fixed set of slots, filled by the caller, and submitted
+ * for decoding. With more than one thread, each worker thread owns its own decoder
+ * instance and decodes the submitted batches concurrently. With a single thread, the
+ * batches are decoded synchronously on the caller's thread when submitted.
+ *
+ * Regardless of the order in which the workers finish, the decoded batches are
+ * retired in the same order as they were submitted. The acquire(), submit(),
+ * front(), and release() functions are meant to be called from a single (producer)
+ * thread, such as the thread running the GNU Radio block's work function. Only the
+ * job queue and the completion flags are shared with the worker threads.
+ */
+class DVBS2RX_API ldpc_decoder_pool
+{
+private:
+    typedef std::unique_ptr<LDPCDecoderInterface> decoder_ptr_t;
+    int d_num_threads;                     /**< Number of decoding threads */
+    int d_code_len;                        /**< Codeword length in bits */
+    int d_batch_size;                      /**< Maximum number of frames per batch */
+    bool d_soft_output;                    /**< Whether to store the decoded LLRs */
+    std::vector<decoder_ptr_t> d_decoders; /**< Decoder instances */
+    std::vector<ldpc_batch_t> d_slots;     /**< Batch buffers */
+    std::vector<ldpc_batch_t*> d_free;     /**< Batches available for filling */
+    std::deque<ldpc_batch_t*> d_inflight;  /**< Batches in submission order */
+    std::deque<ldpc_batch_t*> d_jobs;      /**< Batches waiting for a worker */
+    std::vector<std::thread> d_workers;    /**< Worker threads */
+    std::mutex d_mutex;                    /**< Mutex for the job queue and flags */
+    std::condition_variable d_job_cv;      /**< Signals new jobs to the workers */
+    std::condition_variable d_done_cv;     /**< Signals decoded batches */
+    bool d_stop;                           /**< Whether the workers should exit */
+
+    void init(int batch_size);
+    void worker(LDPCDecoderInterface* decoder);
+    void decode(LDPCDecoderInterface* decoder, ldpc_batch_t* batch);
+
+public:
+    /**
+     * @brief Construct a new LDPC decoder pool.
+     *
+     * @param ldpc LDPC code definition.
+     * @param num_threads Number of decoding threads. When equal to 1 (or lower), the
+     * batches are decoded on the caller's thread, and no worker thread is created.
+     * @param batch_size Maximum number of frames per batch. When equal to 0 (the
+     * default), the batches hold one frame per SIMD lane. Larger batches are decoded
+     * with rolling lanes, i.e., each SIMD lane is refilled with the next frame of the
+     * batch as soon as its current frame converges.
+     */
+    ldpc_decoder_pool(LDPCInterface* ldpc, int num_threads, int batch_size = 0);
+
+    /**
+     * @brief Construct a new LDPC decoder pool with table-specialized decoders.
+     *
+     * Same as the constructor taking the LDPC code definition, but the decoders are
+     * specialized for the parity bit table of the given code configuration, and they
+     * share a single copy of the code's connectivity with all other decoders of the
+     * same code in the process. See
+     * make_ldpc_decoder(dvb_standard_t, dvb_framesize_t, dvb_code_rate_t).
+     *
+     * With the flooding schedule, the pool holds a single decoder with the flooding
+     * schedule instead (see make_ldpc_flooding_decoder()), which decodes one frame at
+     * a time with num_threads threads of its own, while the batches are decoded
+     * synchronously on the caller's thread.
+     *
+     * @param standard DVB standard.
+     * @param framesize FECFRAME size.
+     * @param rate LDPC code rate.
+     * @param num_threads Number of decoding threads.
+     * @param batch_size Maximum number of frames per batch.
+     * @param schedule Decoding schedule.
+     * @param precision Precision of the layered decoders (see
+     * make_ldpc_decoder(dvb_standard_t, dvb_framesize_t, dvb_code_rate_t,
+     * dvb_ldpc_precision_t)). The flooding decoder always uses 8-bit precision.
+     * @throws std::invalid_argument if the code configuration is not supported.
+     */
+    ldpc_decoder_pool(dvb_standard_t standard,
+                      dvb_framesize_t framesize,
+                      dvb_code_rate_t rate,
+                      int num_threads,
+                      int batch_size = 0,
+                      dvb_ldpc_schedule_t schedule = LDPC_SCHEDULE_LAYERED,
+                      dvb_ldpc_precision_t precision = LDPC_PRECISION_INT8);
+    ~ldpc_decoder_pool();
+
+    /**
+     * @brief Get the number of codewords decoded in parallel.
+     * @return int Number of SIMD lanes of the decoders.
+     */
+    int simd_size() const { return d_decoders[0]->simd_size(); }
+
+    /**
+     * @brief Get the maximum number of frames per batch.
+     * @return int Batch size.
+     */
+    int batch_size() const { return d_batch_size; }
+
+    /**
+     * @brief Get the name of the SIMD backend implementing the decoders.
+     * @return const char* Backend name.
+     */
+    const char* impl() const { return d_decoders[0]->impl(); }
+
+    /**
+     * @brief Get the number of submitted batches not retired yet.
+     * @return size_t Number of batches being decoded or waiting to be released.
+     */
+    size_t pending() const { return d_inflight.size(); }
+
+    /**
+     * @brief Set the interval between the convergence checks of the decoders.
+     *
+     * By default, the decoders check the parity equations before every iteration.
+     * With a longer period, they skip the checks in between, at the cost of up to
+     * period - 1 extra iterations once a codeword converges. Must be called before
+     * submitting any batch, as the decoders read the period while decoding.
+     *
+     * @param period Interval in iterations between convergence checks.
+     */
+    void set_check_period(int period);
+
+    /**
+     * @brief Set whether to store the decoded LLRs of each batch.
+     *
+     * By default, on completion, batch->llr holds the decoded LLRs of each frame and
+     * batch->packed holds their hard decisions. When the decoded LLRs are not needed,
+     * the decoders can skip storing them, in which case batch->llr holds unspecified
+     * values on completion. Must be called before submitting any batch.
+     *
+     * @param enable Whether to store the decoded LLRs into batch->llr.
+     */
+    void set_soft_output(bool enable) { d_soft_output = enable; }
+
+    /**
+     * @brief Acquire an empty batch buffer.
+     *
+     * The input LLRs of frame i can be either copied into batch->llr at offset i * N
+     * or, to avoid the copy, referenced in place through batch->frames[i]. All
+     * entries of batch->frames are nullptr on return.
+     *
+     * @return ldpc_batch_t* Batch to be filled with the input LLRs, or nullptr if all
+     * batch buffers are in use.
+     */
+    ldpc_batch_t* acquire();
+
+    /**
+     * @brief Submit a filled batch for decoding.
+     *
+     * The batch may be partially filled, in which case its unused SIMD lanes are
+     * padded with a valid (all-zero) codeword with maximum reliability, which the
+     * decoder accepts immediately without further iterations. On completion,
+     * batch->results holds the remaining trials of each frame, and batch->result
+     * holds the lowest of them, and batch->packed holds the hard decisions of each
+     * frame, N / 8 bytes per frame, with the first bit of the frame on the MSB. The
+     * time spent decoding the batch is given by batch->decode_ms.
+     *
+     * Frames referenced through batch->frames must remain valid until this function
+     * returns. With a single thread, they are read directly by the decoder. With
+     * worker threads, they are copied into the batch before it is queued.
+     *
+     * @param batch Batch previously obtained through acquire() and filled with
+     * batch->n_frames frames.
+     */
+    void submit(ldpc_batch_t* batch);
+
+    /**
+     * @brief Copy the frames referenced by a batch into its own LLR buffer.
+     *
+     * Required before the memory referenced through batch->frames is invalidated
+     * while the batch is still being filled, e.g., when it spans multiple calls to
+     * the work function of a GNU Radio block.
+     *
+     * @param batch Batch previously obtained through acquire() and not submitted yet.
+     */
+    void detach(ldpc_batch_t* batch);
+
+    /**
+     * @brief Get the oldest submitted batch, if already decoded.
+     * @param wait Whether to block until the oldest batch is decoded.
+     * @return ldpc_batch_t* Oldest batch, or nullptr if there is no pending batch or
+     * if the oldest batch is still being decoded and wait is false.
+     */
+    ldpc_batch_t* front(bool wait);
+
+    /**
+     * @brief Release the oldest batch returned by front() back into the pool.
+     */
+    void release();
+};
+
+} // namespace dvbs2rx
+} // namespace gr
+
+#endif // INCLUDED_DVBS2RX_LDPC_DECODER_POOL_H
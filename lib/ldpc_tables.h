@@ -0,0 +1,194 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2018,2019,2024 Ahmet Inan, Ron Economos, Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DVBS2RX_LDPC_TABLES_H
+#define INCLUDED_DVBS2RX_LDPC_TABLES_H
+
+#include "dvb_s2_tables.hh"
+#include "dvb_s2x_tables.hh"
+#include "dvb_t2_tables.hh"
+#include <gnuradio/dvbs2rx/dvb_config.h>
+
+namespace gr {
+namespace dvbs2rx {
+
+/**
+ * @brief Dispatch an LDPC code configuration to the corresponding parity bit table.
+ *
+ * Calls the visitor's member function template "visit" instantiated with the table
+ * type (e.g., DVB_S2_TABLE_B4) that defines the LDPC code. This function holds the
+ * only mapping from the runtime code configuration into the compile-time tables, so
+ * that the table-specific code can be instantiated anywhere the tables are needed.
+ *
+ * @param standard DVB standard.
+ * @param framesize FECFRAME size.
+ * @param rate LDPC code rate.
+ * @param visitor Visitor object with a "template <typename TABLE> T* visit()"
+ * member function returning a pointer type.
+ * @return The value returned by the visitor, or nullptr if the code configuration is
+ * not supported.
+ */
+template <typename VISITOR>
+auto visit_ldpc_table(dvb_standard_t standard,
+                      dvb_framesize_t framesize,
+                      dvb_code_rate_t rate,
+                      VISITOR&& visitor)
+    -> decltype(visitor.template visit<DVB_S2_TABLE_B1>())
+{
+    if (framesize == FECFRAME_NORMAL) {
+        switch (rate) {
+        case C1_4:
+            return visitor.template visit<DVB_S2_TABLE_B1>();
+        case C1_3:
+            return visitor.template visit<DVB_S2_TABLE_B2>();
+        case C2_5:
+            return visitor.template visit<DVB_S2_TABLE_B3>();
+        case C1_2:
+            return visitor.template visit<DVB_S2_TABLE_B4>();
+        case C3_5:
+            return visitor.template visit<DVB_S2_TABLE_B5>();
+        case C2_3:
+            if (standard == STANDARD_DVBS2) {
+                return visitor.template visit<DVB_S2_TABLE_B6>();
+            } else {
+                return visitor.template visit<DVB_T2_TABLE_A3>();
+            }
+        case C3_4:
+            return visitor.template visit<DVB_S2_TABLE_B7>();
+        case C4_5:
+            return visitor.template visit<DVB_S2_TABLE_B8>();
+        case C5_6:
+            return visitor.template visit<DVB_S2_TABLE_B9>();
+        case C8_9:
+            return visitor.template visit<DVB_S2_TABLE_B10>();
+        case C9_10:
+            return visitor.template visit<DVB_S2_TABLE_B11>();
+        case C2_9_VLSNR:
+            return visitor.template visit<DVB_S2X_TABLE_B1>();
+        case C13_45:
+            return visitor.template visit<DVB_S2X_TABLE_B2>();
+        case C9_20:
+            return visitor.template visit<DVB_S2X_TABLE_B3>();
+        case C90_180:
+            return visitor.template visit<DVB_S2X_TABLE_B11>();
+        case C96_180:
+            return visitor.template visit<DVB_S2X_TABLE_B12>();
+        case C11_20:
+            return visitor.template visit<DVB_S2X_TABLE_B4>();
+        case C100_180:
+            return visitor.template visit<DVB_S2X_TABLE_B13>();
+        case C104_180:
+            return visitor.template visit<DVB_S2X_TABLE_B14>();
+        case C26_45:
+            return visitor.template visit<DVB_S2X_TABLE_B5>();
+        case C18_30:
+            return visitor.template visit<DVB_S2X_TABLE_B22>();
+        case C28_45:
+            return visitor.template visit<DVB_S2X_TABLE_B6>();
+        case C23_36:
+            return visitor.template visit<DVB_S2X_TABLE_B7>();
+        case C116_180:
+            return visitor.template visit<DVB_S2X_TABLE_B15>();
+        case C20_30:
+            return visitor.template visit<DVB_S2X_TABLE_B23>();
+        case C124_180:
+            return visitor.template visit<DVB_S2X_TABLE_B16>();
+        case C25_36:
+            return visitor.template visit<DVB_S2X_TABLE_B8>();
+        case C128_180:
+            return visitor.template visit<DVB_S2X_TABLE_B17>();
+        case C13_18:
+            return visitor.template visit<DVB_S2X_TABLE_B9>();
+        case C132_180:
+            return visitor.template visit<DVB_S2X_TABLE_B18>();
+        case C22_30:
+            return visitor.template visit<DVB_S2X_TABLE_B24>();
+        case C135_180:
+            return visitor.template visit<DVB_S2X_TABLE_B19>();
+        case C140_180:
+            return visitor.template visit<DVB_S2X_TABLE_B20>();
+        case C7_9:
+            return visitor.template visit<DVB_S2X_TABLE_B10>();
+        case C154_180:
+            return visitor.template visit<DVB_S2X_TABLE_B21>();
+        default:
+            break;
+        }
+    } else if (framesize == FECFRAME_SHORT) {
+        switch (rate) {
+        case C1_4:
+            return visitor.template visit<DVB_S2_TABLE_C1>();
+        case C1_3:
+            return visitor.template visit<DVB_S2_TABLE_C2>();
+        case C2_5:
+            return visitor.template visit<DVB_S2_TABLE_C3>();
+        case C1_2:
+            return visitor.template visit<DVB_S2_TABLE_C4>();
+        case C3_5:
+            if (standard == STANDARD_DVBS2) {
+                return visitor.template visit<DVB_S2_TABLE_C5>();
+            } else {
+                return visitor.template visit<DVB_T2_TABLE_B3>();
+            }
+        case C2_3:
+            return visitor.template visit<DVB_S2_TABLE_C6>();
+        case C3_4:
+            return visitor.template visit<DVB_S2_TABLE_C7>();
+        case C4_5:
+            return visitor.template visit<DVB_S2_TABLE_C8>();
+        case C5_6:
+            return visitor.template visit<DVB_S2_TABLE_C9>();
+        case C8_9:
+            return visitor.template visit<DVB_S2_TABLE_C10>();
+        case C11_45:
+            return visitor.template visit<DVB_S2X_TABLE_C1>();
+        case C4_15:
+            return visitor.template visit<DVB_S2X_TABLE_C2>();
+        case C14_45:
+            return visitor.template visit<DVB_S2X_TABLE_C3>();
+        case C7_15:
+            return visitor.template visit<DVB_S2X_TABLE_C4>();
+        case C8_15:
+            return visitor.template visit<DVB_S2X_TABLE_C5>();
+        case C26_45:
+            return visitor.template visit<DVB_S2X_TABLE_C6>();
+        case C32_45:
+            return visitor.template visit<DVB_S2X_TABLE_C7>();
+        case C1_5_VLSNR_SF2:
+            return visitor.template visit<DVB_S2_TABLE_C1>();
+        case C11_45_VLSNR_SF2:
+            return visitor.template visit<DVB_S2X_TABLE_C1>();
+        case C1_5_VLSNR:
+            return visitor.template visit<DVB_S2_TABLE_C1>();
+        case C4_15_VLSNR:
+            return visitor.template visit<DVB_S2X_TABLE_C2>();
+        case C1_3_VLSNR:
+            return visitor.template visit<DVB_S2_TABLE_C2>();
+        default:
+            break;
+        }
+    } else {
+        switch (rate) {
+        case C1_5_MEDIUM:
+            return visitor.template visit<DVB_S2X_TABLE_C8>();
+        case C11_45_MEDIUM:
+            return visitor.template visit<DVB_S2X_TABLE_C9>();
+        case C1_3_MEDIUM:
+            return visitor.template visit<DVB_S2X_TABLE_C10>();
+        default:
+            break;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace dvbs2rx
+} // namespace gr
+
+#endif // INCLUDED_DVBS2RX_LDPC_TABLES_H
@@ -0,0 +1,135 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "ldpc_trials_budget.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace gr {
+namespace dvbs2rx {
+
+ldpc_trials_budget::ldpc_trials_budget(int max_trials, int window)
+    : d_max_trials(max_trials),
+      d_min_trials(std::max(1, max_trials / 5)),
+      d_budget(max_trials),
+      d_window(window),
+      d_hist(max_trials + 1),
+      d_window_pos(0),
+      d_window_fill(0),
+      d_failures(0),
+      d_snr_db(0),
+      d_snr_ref_db(0),
+      d_snr_valid(false),
+      d_snr_ref_valid(false),
+      d_fer(0),
+      d_batch_frames(0),
+      d_batch_failures(0)
+{
+    if (max_trials < 1 || window < 1)
+        throw std::invalid_argument("Invalid LDPC trials budget configuration");
+}
+
+void ldpc_trials_budget::add_frame(int iterations, bool converged)
+{
+    // Remove the oldest frame once the window is full
+    if (d_window_fill == d_window.size()) {
+        const int oldest = d_window[d_window_pos];
+        if (oldest < 0)
+            d_failures--;
+        else
+            d_hist[oldest]--;
+    } else {
+        d_window_fill++;
+    }
+
+    if (converged) {
+        iterations = std::min(std::max(iterations, 0), d_max_trials);
+        d_hist[iterations]++;
+        d_window[d_window_pos] = iterations;
+    } else {
+        d_failures++;
+        d_window[d_window_pos] = -1;
+        d_batch_failures++;
+    }
+    d_batch_frames++;
+    d_window_pos = (d_window_pos + 1) % d_window.size();
+}
+
+void ldpc_trials_budget::add_snr(float snr_db)
+{
+    if (!std::isfinite(snr_db))
+        return;
+    d_snr_db = d_snr_valid ? (1 - alpha) * d_snr_db + alpha * snr_db : snr_db;
+    d_snr_valid = true;
+}
+
+int ldpc_trials_budget::update()
+{
+    if (d_batch_frames == 0)
+        return d_budget;
+
+    // The SNR reference tracks the SNR at which the frames decode successfully
+    if (d_batch_failures == 0 && d_snr_valid) {
+        d_snr_ref_db =
+            d_snr_ref_valid ? (1 - alpha) * d_snr_ref_db + alpha * d_snr_db : d_snr_db;
+        d_snr_ref_valid = true;
+    }
+    // The fade detection follows the last few batches, not the whole window
+    d_fer = (1 - alpha) * d_fer + alpha * (float)d_batch_failures / d_batch_frames;
+    d_batch_frames = 0;
+    d_batch_failures = 0;
+
+    const bool fade = d_fer >= fade_fer && d_snr_valid && d_snr_ref_valid &&
+                      d_snr_db < d_snr_ref_db - fade_snr_db;
+    if (fade) {
+        d_budget = d_min_trials;
+    } else if (d_failures > target_fer * d_window_fill) {
+        d_budget = d_max_trials;
+    } else {
+        // 99th percentile of the iterations of the converged frames
+        const size_t n_converged = d_window_fill - d_failures;
+        const size_t target = (size_t)std::ceil(0.99 * n_converged);
+        size_t cum = 0;
+        int p99 = 0;
+        while (p99 < d_max_trials && (cum += d_hist[p99]) < target)
+            p99++;
+        const int margin = 2 + p99 / 4;
+        d_budget = std::min(std::max(p99 + margin, d_min_trials), d_max_trials);
+    }
+    return d_budget;
+}
+
+float ldpc_trials_budget::snr() const
+{
+    return d_snr_valid ? d_snr_db : std::numeric_limits<float>::quiet_NaN();
+}
+
+float ldpc_trials_budget::estimate_snr(const int8_t* channel,
+                                       const uint8_t* decoded,
+                                       int len)
+{
+    int64_t sum = 0;
+    int64_t sum_sq = 0;
+    for (int i = 0; i < len; i++) {
+        const bool bit = (decoded[i / 8] >> (7 - i % 8)) & 1;
+        const int x = bit ? -channel[i] : channel[i];
+        sum += x;
+        sum_sq += x * x;
+    }
+    const double mean = (double)sum / len;
+    // Floor the variance at the variance of the int8 quantization noise, given that
+    // the LLRs of a clean channel may be all saturated
+    const double var = std::max((double)sum_sq / len - mean * mean, 1.0 / 12);
+    return 10 * std::log10(mean * mean / var);
+}
+
+} // namespace dvbs2rx
+} // namespace gr
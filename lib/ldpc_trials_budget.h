@@ -0,0 +1,122 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_DVBS2RX_LDPC_TRIALS_BUDGET_H
+#define INCLUDED_DVBS2RX_LDPC_TRIALS_BUDGET_H
+
+#include <gnuradio/dvbs2rx/api.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace dvbs2rx {
+
+/**
+ * @brief Adaptive budget of LDPC decoding trials (iterations) per frame.
+ *
+ * Tracks the outcome of the most recently decoded frames of a code and the running
+ * post-decoder SNR, and derives the maximum number of trials for the next batches:
+ *
+ * - When the frames are decoding reliably, the budget follows the 99th percentile of
+ *   the recent iteration counts, plus a margin that lets it grow again as soon as the
+ *   frames start converging close to the budget.
+ * - When more than 1% of the recent frames fail to converge, the budget is raised to
+ *   the maximum, as the failing frames may need more iterations.
+ * - When most frames of the last few batches fail while the SNR is well below the
+ *   level at which the frames were last decoded successfully (e.g., during a fade),
+ *   the frames are likely undecodable, and the budget drops to a small floor to avoid
+ *   wasting the maximum number of iterations on each of them.
+ */
+class DVBS2RX_API ldpc_trials_budget
+{
+private:
+    int d_max_trials;          /**< Maximum (and initial) budget */
+    int d_min_trials;          /**< Budget floor used during fades */
+    int d_budget;              /**< Current budget */
+    std::vector<int> d_window; /**< Iterations of the recent frames (-1 if failed) */
+    std::vector<int> d_hist;   /**< Histogram of the iterations within the window */
+    size_t d_window_pos;       /**< Next position to overwrite in the window */
+    size_t d_window_fill;      /**< Number of frames in the window */
+    size_t d_failures;         /**< Number of failed frames in the window */
+    float d_snr_db;            /**< Running post-decoder SNR in dB */
+    float d_snr_ref_db;        /**< Running SNR of the batches decoded successfully */
+    bool d_snr_valid;          /**< Whether d_snr_db holds an estimate already */
+    bool d_snr_ref_valid;      /**< Whether d_snr_ref_db holds an estimate already */
+    float d_fer;               /**< Running frame error rate of the recent batches */
+    int d_batch_frames;        /**< Frames recorded since the last update() */
+    int d_batch_failures;      /**< Failed frames recorded since the last update() */
+
+public:
+    static constexpr float alpha = 0.25;      /**< Averaging factor per batch */
+    static constexpr float fade_snr_db = 1.0; /**< SNR drop that indicates a fade */
+    static constexpr float fade_fer = 0.5;    /**< Frame error rate of a fade */
+    static constexpr float target_fer = 0.01; /**< Tolerated failure rate */
+
+    /**
+     * @brief Construct a new adaptive trials budget.
+     * @param max_trials Maximum number of trials per frame.
+     * @param window Number of recent frames considered by the policy.
+     */
+    ldpc_trials_budget(int max_trials, int window = 256);
+
+    /**
+     * @brief Record the outcome of a decoded frame.
+     * @param iterations Number of decoding iterations spent on the frame.
+     * @param converged Whether the frame converged to a valid codeword.
+     */
+    void add_frame(int iterations, bool converged);
+
+    /**
+     * @brief Record a post-decoder SNR estimate.
+     * @param snr_db SNR in dB, e.g., as given by estimate_snr().
+     */
+    void add_snr(float snr_db);
+
+    /**
+     * @brief Recompute the budget from the frames and SNR recorded so far.
+     *
+     * Meant to be called once per decoded batch, after recording its frames and its
+     * SNR estimate.
+     *
+     * @return int Updated budget.
+     */
+    int update();
+
+    /**
+     * @brief Get the current budget.
+     * @return int Maximum number of trials for the next frames.
+     */
+    int budget() const { return d_budget; }
+
+    /**
+     * @brief Get the running post-decoder SNR.
+     * @return float SNR in dB, or NaN if no estimate has been recorded yet.
+     */
+    float snr() const;
+
+    /**
+     * @brief Estimate the SNR of a frame from its channel LLRs and decoded bits.
+     *
+     * Decision-directed estimate based on the channel LLRs with the signs of the
+     * decoded codeword removed, whose mean and variance give the SNR of the equivalent
+     * binary antipodal channel (equal to Es/N0 for QPSK).
+     *
+     * @param channel Channel (input) LLRs.
+     * @param decoded Decoded bits, packed with the MSB first.
+     * @param len Number of LLRs.
+     * @return float SNR in dB.
+     */
+    static float estimate_snr(const int8_t* channel, const uint8_t* decoded, int len);
+};
+
+} // namespace dvbs2rx
+} // namespace gr
+
+#endif // INCLUDED_DVBS2RX_LDPC_TRIALS_BUDGET_H
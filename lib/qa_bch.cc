@@ -8,6 +8,8 @@
  */
 
 #include "bch.h"
+#include "bch_codes.h"
+#include "bch_decoder_pool.h"
 #include <boost/mpl/list.hpp>
 #include <boost/mpl/pair.hpp>
 #include <boost/test/data/test_case.hpp>
@@ -313,6 +315,69 @@ BOOST_AUTO_TEST_CASE(test_bch_syndrome_u8_codeword)
     }
 }
 
+/**
+ * @brief Reference syndrome computation for u8 array codewords.
+ *
+ * Computes the remainder of the codeword divided by the generator polynomial using the
+ * byte-by-byte LUT and evaluates the remainder polynomial for alpha^i with i from 1 to
+ * 2t, which is how bch_codec computed the syndrome before the slicing-by-8 method.
+ */
+template <typename T, typename P>
+std::vector<T> ref_syndrome(const bch_codec<T, P>& codec,
+                            const galois_field<T>& gf,
+                            uint8_t t,
+                            const std::array<P, 256>& rem_lut,
+                            u8_cptr_t codeword)
+{
+    const auto& g = codec.get_gen_poly();
+    const auto parity_poly = gf2_poly_rem(codeword, codec.get_n() / 8, g, rem_lut);
+    if (parity_poly.is_zero())
+        return {};
+    const auto parity_poly_gf2m = gf2m_poly(&gf, parity_poly);
+    std::vector<T> syndrome;
+    for (int i = 1; i <= (2 * t); i++)
+        syndrome.push_back(parity_poly_gf2m.eval_by_exp(i));
+    return syndrome;
+}
+
+BOOST_AUTO_TEST_CASE(test_bch_dvbs2_syndrome_vs_ref)
+{
+    // Normal and short FECFRAME codes with different t and n, including n values that
+    // are not multiples of 64 bits (the slicing-by-8 word length)
+    const auto params_table = std::vector<std::tuple<uint32_t, uint32_t, uint8_t>>{
+        { 0b10000000000101101, 16200, 12 }, // Normal 1/4
+        { 0b10000000000101101, 43200, 10 }, // Normal 2/3
+        { 0b10000000000101101, 58320, 8 },  // Normal 9/10
+        { 0b100000000101011, 3240, 12 },    // Short 1/4
+        { 0b100000000101011, 14400, 12 }    // Short 8/9
+    };
+    for (const auto& params : params_table) {
+        gf2_poly_u32 prim_poly(std::get<0>(params));
+        galois_field gf(prim_poly);
+        const uint8_t t = std::get<2>(params);
+        bch_codec<uint32_t, bitset256_t> codec(&gf, t, std::get<1>(params));
+        const auto rem_lut = build_gf2_poly_rem_lut(codec.get_gen_poly());
+
+        u8_vector_t codeword(codec.get_n() / 8);
+        fill_random_bytes(codeword); // not necessarily a valid codeword
+        for (uint32_t num_errors = 0; num_errors <= t + 2u; num_errors++) {
+            u8_vector_t rx_codeword = codeword;
+            flip_random_bits(rx_codeword, num_errors);
+            auto syndrome = codec.syndrome(rx_codeword.data());
+            auto expected = ref_syndrome(codec, gf, t, rem_lut, rx_codeword.data());
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                syndrome.begin(), syndrome.end(), expected.begin(), expected.end());
+        }
+
+        // Error-free codewords
+        u8_vector_t msg(codec.get_k() / 8);
+        fill_random_bytes(msg);
+        codec.encode(msg.data(), codeword.data());
+        BOOST_CHECK(codec.syndrome(codeword.data()).empty());
+        BOOST_CHECK(ref_syndrome(codec, gf, t, rem_lut, codeword.data()).empty());
+    }
+}
+
 template <typename T, typename P>
 void check_err_free_syndrome(const bch_codec<T, P>& codec, const galois_field<T>& gf)
 {
@@ -409,6 +474,36 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_bch_err_loc_poly_error_free, type_pair, bch_b
     BOOST_CHECK_EQUAL(err_loc_numbers.size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_bch_err_loc_numbers_quadratic,
+                              type_pair,
+                              bch_base_types)
+{
+    typedef typename type_pair::first T;
+    typedef typename type_pair::second P;
+
+    // BCH code over GF(2 ^ 4)
+    gf2_poly<T> prim_poly(0b10011); // x^4 + x + 1
+    galois_field gf(prim_poly);
+    uint8_t t = 3; // Triple-error-correcting code
+    bch_codec<T, P> codec(&gf, t);
+
+    // Quadratic error-location polynomials "x^2 + x + c" for every non-zero c. The
+    // polynomial has two distinct roots when c = R*(R+1) for some R in GF(2^4) and no
+    // roots otherwise, in which case the error-location numbers should be empty.
+    for (uint32_t i = 0; i < 15; i++) {
+        const T c = gf.get_alpha_i(i);
+        std::set<T> expected_numbers;
+        for (uint32_t r = 0; r < 16; r++) {
+            if ((gf.multiply(r, r) ^ r) == c) // root r (non-zero, given c is non-zero)
+                expected_numbers.insert(gf.inverse(r));
+        }
+        auto sigma = gf2m_poly<T>(&gf, { c, 1, 1 });
+        auto numbers = codec.err_loc_numbers(sigma);
+        BOOST_CHECK(std::set<T>(numbers.begin(), numbers.end()) == expected_numbers);
+        BOOST_CHECK(expected_numbers.size() == 0 || expected_numbers.size() == 2);
+    }
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(test_bch_err_correction, type_pair, bch_base_types)
 {
     typedef typename type_pair::first T;
@@ -746,5 +841,241 @@ BOOST_AUTO_TEST_CASE(test_bch_dvbs2_encode_decode)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_bch_dvbs2_decode_batch)
+{
+    // DVB-S2 Normal 1/2 code
+    gf2_poly_u32 prim_poly(0b10000000000101101); // x^16 + x^5 + x^3 + x^2 + 1
+    galois_field gf(prim_poly);
+    const uint8_t t = 12;
+    bch_codec<uint32_t, bitset256_t> codec(&gf, t, 32400);
+    const uint32_t k_bytes = codec.get_k() / 8;
+    const uint32_t n_bytes = codec.get_n() / 8;
+
+    // Batch of codewords with 0 to t + 2 errors, i.e., including error-free codewords
+    // and codewords with more errors than the code can correct. Also, use a batch size
+    // that does not divide evenly into the groups of codewords processed at once.
+    const size_t n_codewords = 37;
+    u8_vector_t msgs(n_codewords * k_bytes);
+    u8_vector_t codewords(n_codewords * n_bytes);
+    std::vector<uint32_t> n_errors(n_codewords);
+    fill_random_bytes(msgs);
+    for (size_t i = 0; i < n_codewords; i++) {
+        u8_vector_t codeword(n_bytes);
+        codec.encode(msgs.data() + i * k_bytes, codeword.data());
+        n_errors[i] = i % (t + 3);
+        flip_random_bits(codeword, n_errors[i]);
+        std::copy(codeword.begin(), codeword.end(), codewords.begin() + i * n_bytes);
+    }
+
+    // Decode the batch twice with the same working memory
+    bch_codec<uint32_t, bitset256_t>::scratch scratch(codec);
+    for (int i_run = 0; i_run < 2; i_run++) {
+        u8_vector_t decoded_msgs(n_codewords * k_bytes);
+        std::vector<int> corrections(n_codewords);
+        codec.decode_batch(codewords.data(),
+                           decoded_msgs.data(),
+                           n_codewords,
+                           corrections.data(),
+                           scratch);
+
+        for (size_t i = 0; i < n_codewords; i++) {
+            const auto msg = msgs.cbegin() + i * k_bytes;
+            const auto decoded_msg = decoded_msgs.cbegin() + i * k_bytes;
+            if (n_errors[i] <= t) {
+                BOOST_CHECK_EQUAL_COLLECTIONS(
+                    msg, msg + k_bytes, decoded_msg, decoded_msg + k_bytes);
+                BOOST_CHECK_EQUAL(corrections[i], n_errors[i]);
+            }
+
+            // The result must match the decoding of the codeword alone
+            u8_vector_t expected_msg(k_bytes);
+            int expected_corrections =
+                codec.decode(codewords.data() + i * n_bytes, expected_msg.data());
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected_msg.cbegin(),
+                                          expected_msg.cend(),
+                                          decoded_msg,
+                                          decoded_msg + k_bytes);
+            BOOST_CHECK_EQUAL(corrections[i], expected_corrections);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_bch_dvbs2_check_batch)
+{
+    // DVB-S2 Short 1/2 code
+    gf2_poly_u32 prim_poly(0b100000000101011); // x^14 + x^5 + x^3 + x + 1
+    galois_field gf(prim_poly);
+    const uint8_t t = 12;
+    bch_codec<uint32_t, bitset256_t> codec(&gf, t, 7200);
+    const uint32_t k_bytes = codec.get_k() / 8;
+    const uint32_t n_bytes = codec.get_n() / 8;
+
+    // Every third codeword has bit errors, some of which the code could correct
+    const size_t n_codewords = 20;
+    u8_vector_t codewords(n_codewords * n_bytes);
+    for (size_t i = 0; i < n_codewords; i++) {
+        u8_vector_t msg(k_bytes);
+        u8_vector_t codeword(n_bytes);
+        fill_random_bytes(msg);
+        codec.encode(msg.data(), codeword.data());
+        if (i % 3 == 0)
+            flip_random_bits(codeword, 1 + i % (t + 3));
+        std::copy(codeword.begin(), codeword.end(), codewords.begin() + i * n_bytes);
+    }
+
+    // The check flags the codewords with errors and outputs their bytes uncorrected
+    bch_codec<uint32_t, bitset256_t>::scratch scratch(codec);
+    u8_vector_t msgs(n_codewords * k_bytes);
+    std::vector<int> status(n_codewords);
+    codec.check_batch(
+        codewords.data(), msgs.data(), n_codewords, status.data(), scratch);
+    for (size_t i = 0; i < n_codewords; i++) {
+        const auto codeword = codewords.cbegin() + i * n_bytes;
+        const auto msg = msgs.cbegin() + i * k_bytes;
+        BOOST_CHECK_EQUAL(status[i], (i % 3 == 0) ? -1 : 0);
+        BOOST_CHECK_EQUAL_COLLECTIONS(codeword, codeword + k_bytes, msg, msg + k_bytes);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_bch_dvb_gen_poly)
+{
+    // The precomputed generator polynomials match the ones computed from the field
+    for (auto framesize : { FECFRAME_NORMAL, FECFRAME_SHORT, FECFRAME_MEDIUM }) {
+        gf2_poly_u32 prim_poly(get_bch_prim_poly(framesize));
+        galois_field gf(prim_poly);
+        for (uint8_t t : { 8, 10, 12 }) {
+            bch_codec<uint32_t, bitset256_t> codec(&gf, t);
+            BOOST_CHECK(get_bch_gen_poly(framesize, t) == codec.get_gen_poly());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_bch_shortened_codec)
+{
+    // DVB-S2 Normal 1/2 code derived from the Normal 3/5 code
+    gf2_poly_u32 prim_poly(0b10000000000101101); // x^16 + x^5 + x^3 + x^2 + 1
+    galois_field gf(prim_poly);
+    bch_codec<uint32_t, bitset256_t> ref_codec(&gf, 12, 38880);
+    bch_codec<uint32_t, bitset256_t> codec(ref_codec, 32400);
+    bch_codec<uint32_t, bitset256_t> expected_codec(&gf, 12, 32400);
+    BOOST_CHECK_EQUAL(codec.get_n(), 32400);
+    BOOST_CHECK_EQUAL(codec.get_k(), 32208);
+
+    const uint32_t k_bytes = codec.get_k() / 8;
+    const uint32_t n_bytes = codec.get_n() / 8;
+    u8_vector_t msg(k_bytes);
+    u8_vector_t codeword(n_bytes);
+    u8_vector_t expected_codeword(n_bytes);
+    fill_random_bytes(msg);
+    codec.encode(msg.data(), codeword.data());
+    expected_codec.encode(msg.data(), expected_codeword.data());
+    BOOST_CHECK(codeword == expected_codeword);
+
+    flip_random_bits(codeword, 12);
+    u8_vector_t decoded_msg(k_bytes);
+    BOOST_CHECK_EQUAL(codec.decode(codeword.data(), decoded_msg.data()), 12);
+    BOOST_CHECK(decoded_msg == msg);
+}
+
+BOOST_AUTO_TEST_CASE(test_bch_codec_cache)
+{
+    const auto stats0 = get_bch_cache_stats();
+    {
+        // Lookups of the same code return the same codec, while the codes of the same
+        // FECFRAME size share the Galois field
+        auto codec = get_bch_codec(STANDARD_DVBS2, FECFRAME_NORMAL, C1_2);
+        BOOST_REQUIRE(codec != nullptr);
+        BOOST_CHECK_EQUAL(codec->get_n(), 32400);
+        BOOST_CHECK(get_bch_codec(STANDARD_DVBS2, FECFRAME_NORMAL, C1_2) == codec);
+        auto codec_3_5 = get_bch_codec(STANDARD_DVBS2, FECFRAME_NORMAL, C3_5);
+        auto codec_2_3 = get_bch_codec(STANDARD_DVBS2, FECFRAME_NORMAL, C2_3);
+        auto codec_short = get_bch_codec(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+        BOOST_CHECK_EQUAL(codec_3_5->get_n(), 38880);
+        BOOST_CHECK_EQUAL(codec_2_3->get_k(), 43040);
+        BOOST_CHECK_EQUAL(codec_short->get_k(), 7032);
+        const auto stats1 = get_bch_cache_stats();
+        BOOST_CHECK_EQUAL(stats1.misses - stats0.misses, 4u);
+        BOOST_CHECK_EQUAL(stats1.hits - stats0.hits, 1u);
+        BOOST_CHECK_EQUAL(stats1.codecs - stats0.codecs, 4u);
+        BOOST_CHECK_EQUAL(stats1.fields - stats0.fields, 2u);
+
+        // The cached codecs decode like standalone ones
+        gf2_poly_u32 prim_poly(get_bch_prim_poly(FECFRAME_NORMAL));
+        galois_field gf(prim_poly);
+        const std::pair<std::shared_ptr<const dvb_bch_codec_t>, uint8_t> cases[] = {
+            { codec, 12 }, { codec_3_5, 12 }, { codec_2_3, 10 }
+        };
+        for (const auto& test_case : cases) {
+            const auto& cached = test_case.first;
+            bch_codec<uint32_t, bitset256_t> standalone(
+                &gf, test_case.second, cached->get_n());
+            const uint32_t k_bytes = cached->get_k() / 8;
+            const uint32_t n_bytes = cached->get_n() / 8;
+            u8_vector_t msg(k_bytes);
+            u8_vector_t codeword(n_bytes);
+            fill_random_bytes(msg);
+            standalone.encode(msg.data(), codeword.data());
+            flip_random_bits(codeword, 8);
+            u8_vector_t decoded_msg(k_bytes);
+            BOOST_CHECK_EQUAL(cached->decode(codeword.data(), decoded_msg.data()), 8);
+            BOOST_CHECK(decoded_msg == msg);
+        }
+    }
+
+    // The codecs and fields are released with their last users
+    const auto stats2 = get_bch_cache_stats();
+    BOOST_CHECK_EQUAL(stats2.codecs, stats0.codecs);
+    BOOST_CHECK_EQUAL(stats2.fields, stats0.fields);
+    auto codec = get_bch_codec(STANDARD_DVBS2, FECFRAME_NORMAL, C1_2);
+    BOOST_CHECK_EQUAL(get_bch_cache_stats().misses, stats2.misses + 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_bch_decoder_pool)
+{
+    auto codec = get_bch_codec(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    BOOST_REQUIRE(codec != nullptr);
+    const uint8_t t = 12;
+    const uint32_t k_bytes = codec->get_k() / 8;
+    const uint32_t n_bytes = codec->get_n() / 8;
+
+    // Codewords with 0 to t + 2 errors
+    const size_t n_codewords = 45;
+    u8_vector_t codewords(n_codewords * n_bytes);
+    for (size_t i = 0; i < n_codewords; i++) {
+        u8_vector_t msg(k_bytes);
+        u8_vector_t codeword(n_bytes);
+        fill_random_bytes(msg);
+        codec->encode(msg.data(), codeword.data());
+        flip_random_bits(codeword, i % (t + 3));
+        std::copy(codeword.begin(), codeword.end(), codewords.begin() + i * n_bytes);
+    }
+    u8_vector_t expected_msgs(n_codewords * k_bytes);
+    std::vector<int> expected_corrections(n_codewords);
+    codec->decode_batch(codewords.data(),
+                        expected_msgs.data(),
+                        n_codewords,
+                        expected_corrections.data());
+
+    // The pool decodes in input order regardless of the number of threads, including
+    // batches with fewer codewords than threads
+    for (int num_threads : { 1, 2, 3, 8 }) {
+        bch_decoder_pool pool(codec, num_threads);
+        BOOST_CHECK_EQUAL(pool.num_threads(), num_threads);
+        for (size_t n : { n_codewords, size_t(5), size_t(1) }) {
+            u8_vector_t msgs(n * k_bytes);
+            std::vector<int> corrections(n);
+            pool.decode_batch(codewords.data(), msgs.data(), n, corrections.data());
+            BOOST_CHECK_EQUAL_COLLECTIONS(msgs.cbegin(),
+                                          msgs.cend(),
+                                          expected_msgs.cbegin(),
+                                          expected_msgs.cbegin() + n * k_bytes);
+            BOOST_CHECK_EQUAL_COLLECTIONS(corrections.cbegin(),
+                                          corrections.cend(),
+                                          expected_corrections.cbegin(),
+                                          expected_corrections.cbegin() + n);
+        }
+    }
+}
+
 } // namespace dvbs2rx
 } // namespace gr
\ No newline at end of file
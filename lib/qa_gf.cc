@@ -11,12 +11,14 @@
 #include <boost/mpl/list.hpp>
 #include <boost/test/data/test_case.hpp>
 #include <boost/test/unit_test.hpp>
+#include <random>
 #include <set>
 
 namespace gr {
 namespace dvbs2rx {
 
 typedef boost::mpl::list<uint16_t, uint32_t, uint64_t> gf_elem_types;
+typedef boost::mpl::list<uint32_t, uint64_t> gf_elem_types_32_64;
 typedef boost::mpl::list<uint16_t, uint32_t, uint64_t, bitset256_t> gf2_poly_base_types;
 
 
@@ -516,5 +518,65 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_gf2m_poly_root_search, T, gf_elem_types)
     }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_gf2m_poly_root_search_long_range,
+                              T,
+                              gf_elem_types_32_64)
+{
+    gf2_poly<T> prim_poly(0b10000000000101101); // x^16 + x^5 + x^3 + x^2 + 1
+    galois_field gf(prim_poly);
+    uint32_t two_to_m_minus_one = (1 << gf.get_m()) - 1;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<uint32_t> exp_dist(0, two_to_m_minus_one - 1);
+
+    // Ranges of exponents long enough for the bit-sliced search, including the full
+    // range and ranges that do not fill all bit-sliced lanes evenly.
+    const std::vector<std::pair<uint32_t, uint32_t>> ranges = {
+        { 1, two_to_m_minus_one }, // full range
+        { 7216, two_to_m_minus_one },
+        { 33007, 50000 },
+        { 100, 1123 },
+    };
+
+    for (const auto& range : ranges) {
+        const uint32_t i_start = range.first;
+        const uint32_t i_end = range.second;
+        for (uint32_t degree : { 1, 2, 8, 12 }) {
+            // Polynomial with distinct roots, some in the range and some outside it
+            std::set<uint32_t> root_exps;
+            while (root_exps.size() < degree)
+                root_exps.insert(exp_dist(gen));
+            gf2m_poly<T> poly(&gf, { gf.get_alpha_i(exp_dist(gen)) });
+            for (uint32_t root_exp : root_exps)
+                poly = poly * gf2m_poly<T>(&gf, { gf.get_alpha_i(root_exp), 1 });
+
+            // Brute-force search for reference
+            std::vector<uint32_t> expected;
+            for (uint32_t i = i_start; i <= i_end; i++) {
+                if (poly.eval_by_exp(i) == 0)
+                    expected.push_back(i);
+            }
+
+            auto found = poly.search_roots_in_exp_range(i_start, i_end);
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                found.cbegin(), found.cend(), expected.cbegin(), expected.cend());
+
+            // When limited to fewer roots, the search should return the lowest ones
+            if (expected.size() > 1) {
+                uint32_t max_roots = expected.size() - 1;
+                found = poly.search_roots_in_exp_range(i_start, i_end, max_roots);
+                BOOST_CHECK_EQUAL_COLLECTIONS(found.cbegin(),
+                                              found.cend(),
+                                              expected.cbegin(),
+                                              expected.cbegin() + max_roots);
+            }
+        }
+
+        // Polynomial without roots in GF(2^16), as x^3 + x + 1 is irreducible over GF(2)
+        // and its roots lie in GF(2^3), which is not a subfield of GF(2^16).
+        gf2m_poly<T> irreducible(&gf, gf2_poly<T>(0b1011)); // x^3 + x + 1
+        BOOST_CHECK(irreducible.search_roots_in_exp_range(i_start, i_end).empty());
+    }
+}
+
 } // namespace dvbs2rx
 } // namespace gr
\ No newline at end of file
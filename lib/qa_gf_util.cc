@@ -95,6 +95,37 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_remainder, T, gf2_poly_base_types)
     }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_remainder_slicing, T, gf2_poly_base_types)
+{
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<> dis(0, 255);
+
+    // Divisors of degree 3, 8, and 10 (same as above)
+    std::vector<gf2_poly<T>> divisors = { gf2_poly<T>(0b1011), gf2_poly<T>(0b100011101) };
+    if (sizeof(T) >= 4) // see the LUT limitation on build_gf2_poly_rem_lut
+        divisors.push_back(gf2_poly<T>(0b10000001001));
+    for (const auto& g : divisors) {
+        auto rem_lut = build_gf2_poly_rem_lut(g);
+        auto slicing_lut = build_gf2_poly_rem_slicing_lut(g);
+        BOOST_CHECK_EQUAL(slicing_lut.size(), 8 * 256); // single 64-bit word
+        // Dividends with sizes that are not necessarily multiples of 8 bytes
+        for (int size = 1; size <= 24; size++) {
+            std::vector<uint8_t> y(size);
+            for (auto& byte : y)
+                byte = dis(gen);
+
+            // The sliced computation yields "(y * x^d) % g", left-aligned on the word.
+            // Compute the same by multiplying the regular remainder by x, d times.
+            auto expected = gf2_poly_rem(y, g, rem_lut);
+            for (int i = 0; i < g.degree(); i++)
+                expected = gf2_poly<T>(expected.get_poly() << 1) % g;
+
+            uint64_t rem;
+            gf2_poly_rem_sliced(y.data(), size, slicing_lut, &rem);
+            BOOST_CHECK(gf2_poly<T>(rem >> (64 - g.degree())) == expected);
+        }
+    }
+}
 
 } // namespace dvbs2rx
 } // namespace gr
\ No newline at end of file
@@ -0,0 +1,861 @@
+/* -*- c++ -*- */
+/*
+ * Copyright (c) 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "fec_params.h"
+#include "ldpc_backend.h"
+#include "ldpc_decoder_pool.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace dvbs2rx {
+
+/**
+ * @brief Encode a message using the IRA structure of the DVB LDPC codes.
+ *
+ * @param ldpc LDPC code definition.
+ * @param msg Message bits (one bit per byte).
+ * @return std::vector<uint8_t> Codeword bits (one bit per byte) in the standard order,
+ * with the message bits followed by the parity bits.
+ */
+std::vector<uint8_t> ldpc_encode(LDPCInterface* ldpc, const std::vector<uint8_t>& msg)
+{
+    const int n = ldpc->code_len();
+    const int k = ldpc->data_len();
+    std::vector<uint8_t> codeword(msg.begin(), msg.end());
+    codeword.resize(n, 0);
+    uint8_t* parity = codeword.data() + k;
+    // Accumulate each message bit into the parity bits it participates in
+    std::unique_ptr<LDPCInterface> it(ldpc->clone());
+    it->first_bit();
+    for (int j = 0; j < k; j++) {
+        const int* acc_pos = it->acc_pos();
+        for (int i = 0; i < it->bit_deg(); i++)
+            parity[acc_pos[i]] ^= msg[j];
+        it->next_bit();
+    }
+    // Staircase (accumulator) structure of the parity part
+    for (int i = 1; i < (n - k); i++)
+        parity[i] ^= parity[i - 1];
+    return codeword;
+}
+
+/**
+ * @brief Generate a batch of noisy LLRs for random codewords.
+ *
+ * Maps each codeword bit to BPSK (bit 0 to +1 and bit 1 to -1), adds white Gaussian
+ * noise, and quantizes the result into the int8 LLR format taken by the decoder.
+ *
+ * @param ldpc LDPC code definition.
+ * @param n_codewords Number of codewords in the batch.
+ * @param esn0_db Target Es/N0 in dB.
+ * @param seed Seed for the pseudo-random number generator.
+ * @param codewords Output vector with the transmitted codeword bits.
+ * @param llrs Output vector with the corresponding noisy LLRs.
+ */
+void gen_noisy_batch(LDPCInterface* ldpc,
+                     int n_codewords,
+                     float esn0_db,
+                     unsigned int seed,
+                     std::vector<uint8_t>& codewords,
+                     std::vector<int8_t>& llrs)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<> bit_dis(0, 1);
+    const float n0 = std::pow(10.0f, -esn0_db / 10);
+    std::normal_distribution<float> noise_dis(0, std::sqrt(n0 / 2));
+    const int n = ldpc->code_len();
+    const int k = ldpc->data_len();
+    const float scale = 4.0f / n0; // same LLR scaling as the XFECFRAME demapper
+
+    codewords.resize(n_codewords * n);
+    llrs.resize(n_codewords * n);
+    for (int i = 0; i < n_codewords; i++) {
+        std::vector<uint8_t> msg(k);
+        for (int j = 0; j < k; j++)
+            msg[j] = bit_dis(gen);
+        std::vector<uint8_t> codeword = ldpc_encode(ldpc, msg);
+        for (int j = 0; j < n; j++) {
+            float rx = (codeword[j] ? -1.0f : 1.0f) + noise_dis(gen);
+            float llr = std::round(scale * rx);
+            codewords[i * n + j] = codeword[j];
+            llrs[i * n + j] = std::max(-128.0f, std::min(127.0f, llr));
+        }
+    }
+}
+
+int count_bit_errors(const std::vector<uint8_t>& codewords,
+                     const std::vector<int8_t>& llrs)
+{
+    int n_errors = 0;
+    for (size_t i = 0; i < codewords.size(); i++)
+        n_errors += (llrs[i] < 0) != codewords[i];
+    return n_errors;
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_encoder_parity_checks)
+{
+    // The all-ones message should produce a valid codeword, i.e., one that the
+    // decoder accepts immediately without using any trial.
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    auto decoder = make_ldpc_decoder(ldpc.get());
+    const int n = ldpc->code_len();
+    const int simd_size = decoder->simd_size();
+    std::vector<uint8_t> msg(ldpc->data_len(), 1);
+    std::vector<uint8_t> codeword = ldpc_encode(ldpc.get(), msg);
+    std::vector<int8_t> llrs(simd_size * n);
+    for (int i = 0; i < simd_size; i++)
+        for (int j = 0; j < n; j++)
+            llrs[i * n + j] = codeword[j] ? -16 : 16;
+    const int trials = 25;
+    BOOST_CHECK_EQUAL(decoder->decode(llrs.data(), trials), trials);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_unsupported_code)
+{
+    BOOST_CHECK(make_ldpc_code(STANDARD_DVBS2, FECFRAME_MEDIUM, C1_2) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_concurrent_instances)
+{
+    // Two decoders configured with different code rates running concurrently
+    struct decoder_test_t {
+        dvb_code_rate_t rate;
+        float esn0_db;
+        std::unique_ptr<LDPCInterface> ldpc;
+        std::unique_ptr<LDPCDecoderInterface> decoder;
+        std::vector<std::vector<uint8_t>> codewords;
+        std::vector<std::vector<int8_t>> llrs;
+        std::vector<std::vector<int8_t>> ref_out;
+    };
+    const int n_batches = 4;
+    const int trials = 25;
+    std::vector<decoder_test_t> tests(2);
+    tests[0].rate = C1_2;
+    tests[0].esn0_db = 3.0;
+    tests[1].rate = C8_9;
+    tests[1].esn0_db = 8.0;
+
+    for (auto& test : tests) {
+        test.ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, test.rate);
+        test.decoder = make_ldpc_decoder(test.ldpc.get());
+        test.codewords.resize(n_batches);
+        test.llrs.resize(n_batches);
+        for (int i = 0; i < n_batches; i++) {
+            gen_noisy_batch(test.ldpc.get(),
+                            test.decoder->simd_size(),
+                            test.esn0_db,
+                            i,
+                            test.codewords[i],
+                            test.llrs[i]);
+            // Make sure the decoder has errors to correct
+            BOOST_CHECK_GT(count_bit_errors(test.codewords[i], test.llrs[i]), 0);
+        }
+    }
+
+    // Reference results obtained by decoding each batch on independent decoder
+    // instances without concurrency
+    for (auto& test : tests) {
+        auto ref_decoder = make_ldpc_decoder(test.ldpc.get());
+        for (const auto& llrs : test.llrs) {
+            std::vector<int8_t> out = llrs;
+            ref_decoder->decode(out.data(), trials);
+            test.ref_out.push_back(out);
+        }
+    }
+
+    // Decode concurrently on separate threads
+    std::vector<std::vector<std::vector<int8_t>>> out(tests.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < tests.size(); t++) {
+        threads.emplace_back([&, t]() {
+            for (const auto& llrs : tests[t].llrs) {
+                std::vector<int8_t> decoded = llrs;
+                tests[t].decoder->decode(decoded.data(), trials);
+                out[t].push_back(decoded);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t t = 0; t < tests.size(); t++) {
+        for (int i = 0; i < n_batches; i++) {
+            BOOST_CHECK(out[t][i] == tests[t].ref_out[i]);
+            BOOST_CHECK_EQUAL(count_bit_errors(tests[t].codewords[i], out[t][i]), 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_pool_in_order)
+{
+    const int n_threads = 3;
+    const int n_batches = 8;
+    const int trials = 25;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    ldpc_decoder_pool pool(ldpc.get(), n_threads);
+    const int simd_size = pool.simd_size();
+
+    // Alternate between noisy and clean batches so that the workers finish decoding
+    // out of order, and obtain the reference results through serial decoding.
+    std::vector<std::vector<uint8_t>> codewords(n_batches);
+    std::vector<std::vector<int8_t>> llrs(n_batches);
+    std::vector<std::vector<int8_t>> ref_out(n_batches);
+    auto ref_decoder = make_ldpc_decoder(ldpc.get());
+    for (int i = 0; i < n_batches; i++) {
+        float esn0_db = (i % 2 == 0) ? 2.5 : 10.0;
+        gen_noisy_batch(ldpc.get(), simd_size, esn0_db, i, codewords[i], llrs[i]);
+        ref_out[i] = llrs[i];
+        ref_decoder->decode(ref_out[i].data(), trials);
+    }
+
+    std::vector<uint64_t> retired_frame_cnt;
+    std::vector<std::vector<int8_t>> out;
+    auto retire = [&](bool wait) {
+        ldpc_batch_t* batch = pool.front(wait);
+        if (batch == nullptr)
+            return false;
+        retired_frame_cnt.push_back(batch->frame_cnt);
+        out.push_back(batch->llr);
+        pool.release();
+        return true;
+    };
+
+    int i_batch = 0;
+    while (i_batch < n_batches) {
+        ldpc_batch_t* batch = pool.acquire();
+        if (batch == nullptr) {
+            BOOST_REQUIRE(retire(/*wait=*/true));
+            continue;
+        }
+        batch->llr = llrs[i_batch];
+        batch->frame_cnt = i_batch * simd_size;
+        batch->n_frames = simd_size;
+        batch->trials = trials;
+        pool.submit(batch);
+        i_batch++;
+    }
+    while (pool.pending() > 0)
+        BOOST_REQUIRE(retire(/*wait=*/true));
+    BOOST_CHECK(pool.front(/*wait=*/false) == nullptr);
+
+    BOOST_REQUIRE_EQUAL(out.size(), n_batches);
+    for (int i = 0; i < n_batches; i++) {
+        BOOST_CHECK_EQUAL(retired_frame_cnt[i], i * simd_size);
+        BOOST_CHECK(out[i] == ref_out[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_pool_partial_batch)
+{
+    const int trials = 25;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C3_5);
+    const int n = ldpc->code_len();
+    for (int n_threads : { 1, 2 }) {
+        ldpc_decoder_pool pool(ldpc.get(), n_threads);
+        const int simd_size = pool.simd_size();
+        std::vector<uint8_t> codewords;
+        std::vector<int8_t> llrs;
+        gen_noisy_batch(ldpc.get(), simd_size, 4.0, 0, codewords, llrs);
+
+        // Fill only a few frames in the batch and leave garbage on the other lanes
+        for (int n_frames : { 1, 3, simd_size - 1 }) {
+            ldpc_batch_t* batch = pool.acquire();
+            BOOST_REQUIRE(batch != nullptr);
+            std::fill(batch->llr.begin(), batch->llr.end(), -1);
+            std::copy(llrs.begin(), llrs.begin() + n_frames * n, batch->llr.begin());
+            batch->frame_cnt = 0;
+            batch->n_frames = n_frames;
+            batch->trials = trials;
+            pool.submit(batch);
+            batch = pool.front(/*wait=*/true);
+            BOOST_REQUIRE(batch != nullptr);
+            // The padded lanes should not prevent convergence
+            BOOST_CHECK_GE(batch->result, 0);
+            const int len = n_frames * n;
+            std::vector<int8_t> out(batch->llr.begin(), batch->llr.begin() + len);
+            std::vector<uint8_t> ref(codewords.begin(), codewords.begin() + len);
+            BOOST_CHECK_EQUAL(count_bit_errors(ref, out), 0);
+            pool.release();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_rolling_lanes)
+{
+    // One hard frame per group of simd_size frames, with all other frames easy. With
+    // fixed batches, every batch takes as many iterations as its hard frame. With
+    // rolling lanes, the easy frames keep flowing through the other lanes.
+    const int trials = 25;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    auto decoder = make_ldpc_decoder(ldpc.get());
+    const int n = ldpc->code_len();
+    const int simd_size = decoder->simd_size();
+    const int n_batches = 4;
+    const int n_frames = n_batches * simd_size;
+    std::vector<uint8_t> codewords(n_frames * n);
+    std::vector<int8_t> llrs(n_frames * n);
+    for (int i = 0; i < n_frames; i++) {
+        std::vector<uint8_t> codeword;
+        std::vector<int8_t> llr;
+        float esn0_db = (i % simd_size == 0) ? 2.5 : 10.0;
+        gen_noisy_batch(ldpc.get(), 1, esn0_db, i, codeword, llr);
+        std::copy(codeword.begin(), codeword.end(), codewords.begin() + i * n);
+        std::copy(llr.begin(), llr.end(), llrs.begin() + i * n);
+    }
+
+    int batch_iterations = 0;
+    for (int i = 0; i < n_batches; i++) {
+        std::vector<int8_t> batch(llrs.begin() + i * simd_size * n,
+                                  llrs.begin() + (i + 1) * simd_size * n);
+        int result = decoder->decode(batch.data(), trials);
+        BOOST_REQUIRE_GE(result, 0);
+        batch_iterations += trials - result;
+    }
+
+    std::vector<int8_t> out = llrs;
+    std::vector<int> results(n_frames);
+    int rolling_iterations =
+        decoder->decode_rolling(out.data(), n_frames, results.data(), trials);
+    BOOST_CHECK_EQUAL(count_bit_errors(codewords, out), 0);
+    int max_frame_iterations = 0;
+    for (int i = 0; i < n_frames; i++) {
+        BOOST_CHECK_GE(results[i], 0);
+        max_frame_iterations = std::max(max_frame_iterations, trials - results[i]);
+    }
+    BOOST_CHECK_GE(rolling_iterations, max_frame_iterations);
+    BOOST_CHECK_LT(rolling_iterations, batch_iterations);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_check_period)
+{
+    // Checking the convergence every few iterations must decode the same codewords,
+    // with at most period - 1 extra iterations
+    const int trials = 25;
+    const int period = 3;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    auto decoder = make_ldpc_decoder(ldpc.get());
+    const int simd_size = decoder->simd_size();
+    std::vector<uint8_t> codewords;
+    std::vector<int8_t> llrs;
+    gen_noisy_batch(ldpc.get(), 2 * simd_size, 2.0, 5, codewords, llrs);
+    const int batch_len = simd_size * ldpc->code_len();
+    const std::vector<uint8_t> batch_codewords(codewords.begin(),
+                                               codewords.begin() + batch_len);
+
+    int iterations[2];
+    std::vector<int> results[2];
+    for (int p : { 1, period }) {
+        const int k = p > 1;
+        decoder->set_check_period(p);
+        std::vector<int8_t> out(llrs.begin(), llrs.begin() + batch_len);
+        int result = decoder->decode(out.data(), trials);
+        BOOST_REQUIRE_GE(result, 0);
+        BOOST_CHECK_EQUAL(count_bit_errors(batch_codewords, out), 0);
+        iterations[k] = trials - result;
+
+        results[k].resize(2 * simd_size);
+        out = llrs;
+        decoder->decode_rolling(out.data(), 2 * simd_size, results[k].data(), trials);
+        BOOST_CHECK_EQUAL(count_bit_errors(codewords, out), 0);
+    }
+    BOOST_CHECK_GE(iterations[1], iterations[0]);
+    BOOST_CHECK_LT(iterations[1], iterations[0] + period);
+    for (int i = 0; i < 2 * simd_size; i++) {
+        BOOST_CHECK_GE(results[1][i], 0);
+        BOOST_CHECK_LE(results[1][i], results[0][i]);
+        BOOST_CHECK_GT(results[1][i], results[0][i] - period);
+    }
+
+    // A codeword that does not converge still fails
+    std::vector<int8_t> noise(batch_len);
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> llr_dist(-8, 8);
+    for (auto& llr : noise)
+        llr = llr_dist(gen);
+    BOOST_CHECK_LT(decoder->decode(noise.data(), trials), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_frame_pointers)
+{
+    // Decoding from per-frame pointers (with nullptr lanes as padding) and packing the
+    // hard decisions out of the decoder must match decoding a contiguous batch in place
+    const int trials = 25;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C3_5);
+    auto decoder = make_ldpc_decoder(ldpc.get());
+    const int n = ldpc->code_len();
+    const int simd_size = decoder->simd_size();
+    std::vector<uint8_t> codewords;
+    std::vector<int8_t> llrs;
+    gen_noisy_batch(ldpc.get(), 2 * simd_size, 4.0, 7, codewords, llrs);
+
+    for (int n_frames : { simd_size, 1, simd_size - 1 }) {
+        // Reference: frames copied into a contiguous buffer padded with 127
+        std::vector<int8_t> ref(simd_size * n, 127);
+        std::vector<const int8_t*> frames(simd_size, nullptr);
+        for (int i = 0; i < n_frames; i++) {
+            // Frames taken out of order from a larger buffer
+            const int8_t* frame = llrs.data() + (2 * i + 1) % (2 * simd_size) * n;
+            std::copy(frame, frame + n, ref.begin() + i * n);
+            frames[i] = frame;
+        }
+        const int ref_result = decoder->decode(ref.data(), trials);
+        BOOST_REQUIRE_GE(ref_result, 0);
+
+        BOOST_CHECK_EQUAL(decoder->decode(frames.data(), trials), ref_result);
+        std::vector<uint8_t> bytes(simd_size * n / 8 + 1, 0xa5);
+        decoder->pack(bytes.data(), n);
+        BOOST_CHECK_EQUAL(bytes.back(), 0xa5);
+        bytes.pop_back();
+        std::vector<uint8_t> ref_bytes(simd_size * n / 8);
+        ldpc_pack_hard_decisions(ref_bytes.data(), ref.data(), simd_size * n);
+        BOOST_CHECK(bytes == ref_bytes);
+        std::vector<int8_t> out(simd_size * n);
+        decoder->store(out.data());
+        BOOST_CHECK(out == ref);
+    }
+
+    // Rolling lanes, reading the frames in place and writing the decoded LLRs apart
+    const int n_frames = 2 * simd_size;
+    std::vector<const int8_t*> frames(n_frames);
+    for (int i = 0; i < n_frames; i++)
+        frames[i] = llrs.data() + i * n;
+    std::vector<int8_t> out(n_frames * n);
+    std::vector<int> results(n_frames), ref_results(n_frames);
+    const int result = decoder->decode_rolling(
+        frames.data(), out.data(), n_frames, results.data(), trials);
+    std::vector<int8_t> ref = llrs;
+    const int ref_result =
+        decoder->decode_rolling(ref.data(), n_frames, ref_results.data(), trials);
+    BOOST_CHECK_EQUAL(result, ref_result);
+    BOOST_CHECK(results == ref_results);
+    BOOST_CHECK(out == ref);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_lane_results)
+{
+    // The unused trials tracked on each lane must match those obtained by decoding
+    // the lane's frame alone, while the decoded batch remains the same
+    const int trials = 25;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    auto decoder = make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    const int n = ldpc->code_len();
+    const int simd_size = decoder->simd_size();
+    // Frames from a range of SNRs, some of them failing, with the last lane unused
+    std::vector<int8_t> llrs(simd_size * n);
+    std::vector<const int8_t*> frames(simd_size, nullptr);
+    for (int i = 0; i < simd_size - 1; i++) {
+        std::vector<uint8_t> codewords;
+        std::vector<int8_t> frame_llrs;
+        gen_noisy_batch(ldpc.get(), 1, -3.0 + 0.25 * (i % 12), i, codewords, frame_llrs);
+        std::copy(frame_llrs.begin(), frame_llrs.end(), llrs.begin() + i * n);
+        frames[i] = llrs.data() + i * n;
+    }
+
+    const int ref_result = decoder->decode(frames.data(), trials);
+    std::vector<int8_t> ref_out(simd_size * n);
+    decoder->store(ref_out.data());
+
+    std::vector<int> results(simd_size);
+    const int result = decoder->decode(frames.data(), results.data(), trials);
+    std::vector<int8_t> out(simd_size * n);
+    decoder->store(out.data());
+    BOOST_CHECK_EQUAL(result, ref_result);
+    BOOST_CHECK_EQUAL(result, *std::min_element(results.begin(), results.end()));
+    BOOST_CHECK(out == ref_out);
+    BOOST_CHECK_EQUAL(results.back(), trials);
+
+    bool any_failed = false, any_differ = false;
+    for (int i = 0; i < simd_size - 1; i++) {
+        std::vector<const int8_t*> single(simd_size, nullptr);
+        single[0] = frames[i];
+        BOOST_CHECK_EQUAL(results[i], decoder->decode(single.data(), trials));
+        any_failed |= results[i] < 0;
+        any_differ |= results[i] != results[0];
+    }
+    BOOST_CHECK(any_failed);
+    BOOST_CHECK(any_differ);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_pool_frame_pointers)
+{
+    const int trials = 25;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C2_3);
+    const int n = ldpc->code_len();
+    auto decoder = make_ldpc_decoder(ldpc.get());
+    const int simd_size = decoder->simd_size();
+    std::vector<uint8_t> codewords;
+    std::vector<int8_t> llrs;
+    gen_noisy_batch(ldpc.get(), 2 * simd_size + 3, 5.0, 9, codewords, llrs);
+    std::vector<uint8_t> ref(codewords.size() / 8);
+    for (size_t j = 0; j < ref.size(); j++)
+        for (int k = 0; k < 8; k++)
+            ref[j] |= codewords[j * 8 + k] << (7 - k);
+
+    for (int n_threads : { 1, 2 }) {
+        for (int batch_size : { 0, 2 * simd_size + 3 }) {
+            ldpc_decoder_pool pool(ldpc.get(), n_threads, batch_size);
+            pool.set_soft_output(false);
+            const int n_frames = pool.batch_size() - 1;
+            // Half of the frames referenced in place, the other half copied
+            std::vector<int8_t> input(llrs.begin(), llrs.begin() + n_frames * n);
+            ldpc_batch_t* batch = pool.acquire();
+            BOOST_REQUIRE(batch != nullptr);
+            for (int i = 0; i < n_frames; i++) {
+                BOOST_CHECK(batch->frames[i] == nullptr);
+                if (i % 2)
+                    batch->frames[i] = input.data() + i * n;
+                else
+                    std::copy_n(input.begin() + i * n, n, batch->llr.begin() + i * n);
+            }
+            batch->frame_cnt = 0;
+            batch->n_frames = n_frames;
+            batch->trials = trials;
+            pool.submit(batch);
+            // The referenced frames are not needed after submission
+            std::fill(input.begin(), input.end(), 0);
+            batch = pool.front(/*wait=*/true);
+            BOOST_REQUIRE(batch != nullptr);
+            BOOST_CHECK_GE(batch->result, 0);
+            const int len = n_frames * n / 8;
+            BOOST_CHECK(
+                std::equal(ref.begin(), ref.begin() + len, batch->packed.begin()));
+            pool.release();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_flooding_decoder)
+{
+    // Splitting each codeword across threads must not change the decoding results
+    const int trials = 50;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    const int n = ldpc->code_len();
+    const int n_frames = 4;
+    std::vector<uint8_t> codewords;
+    std::vector<int8_t> llrs;
+    gen_noisy_batch(ldpc.get(), n_frames, 3.0, 13, codewords, llrs);
+
+    std::vector<int> ref_results;
+    std::vector<int8_t> ref_out;
+    for (int n_threads : { 1, 3 }) {
+        auto decoder = make_ldpc_flooding_decoder(ldpc.get(), n_threads);
+        BOOST_CHECK_EQUAL(decoder->simd_size(), 1);
+        std::vector<int8_t> out = llrs;
+        std::vector<int> results(n_frames);
+        for (int i = 0; i < n_frames; i++) {
+            results[i] = decoder->decode(out.data() + i * n, trials);
+            BOOST_CHECK_GE(results[i], 0);
+        }
+        BOOST_CHECK_EQUAL(count_bit_errors(codewords, out), 0);
+        if (ref_results.empty()) {
+            ref_results = results;
+            ref_out = out;
+        } else {
+            BOOST_CHECK(results == ref_results);
+            BOOST_CHECK(out == ref_out);
+        }
+
+        // Reading the frame in place and packing the hard decisions
+        const int8_t* frame = llrs.data() + n;
+        BOOST_CHECK_EQUAL(decoder->decode(&frame, trials), ref_results[1]);
+        std::vector<uint8_t> bytes(n / 8), ref_bytes(n / 8);
+        decoder->pack(bytes.data(), n);
+        ldpc_pack_hard_decisions(ref_bytes.data(), ref_out.data() + n, n);
+        BOOST_CHECK(bytes == ref_bytes);
+
+        // A null frame is the all-zero codeword, which is accepted immediately
+        const int8_t* padding = nullptr;
+        BOOST_CHECK_EQUAL(decoder->decode(&padding, trials), trials);
+        decoder->pack(bytes.data(), n);
+        BOOST_CHECK(std::count(bytes.begin(), bytes.end(), 0) == n / 8);
+    }
+
+    // Pool decoding one frame at a time with the flooding schedule
+    ldpc_decoder_pool pool(
+        STANDARD_DVBS2, FECFRAME_SHORT, C1_2, 2, 0, LDPC_SCHEDULE_FLOODING);
+    BOOST_CHECK_EQUAL(pool.simd_size(), 1);
+    BOOST_CHECK_EQUAL(std::string(pool.impl()), "flooding");
+    ldpc_batch_t* batch = pool.acquire();
+    BOOST_REQUIRE(batch != nullptr);
+    batch->frames[0] = llrs.data();
+    batch->frame_cnt = 0;
+    batch->n_frames = 1;
+    batch->trials = trials;
+    pool.submit(batch);
+    batch = pool.front(/*wait=*/true);
+    BOOST_REQUIRE(batch != nullptr);
+    BOOST_CHECK_EQUAL(batch->result, ref_results[0]);
+    std::vector<int8_t> out(batch->llr.begin(), batch->llr.begin() + n);
+    BOOST_CHECK(std::equal(out.begin(), out.end(), ref_out.begin()));
+    pool.release();
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_pool_rolling_batch)
+{
+    const int trials = 25;
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C2_3);
+    const int n = ldpc->code_len();
+    for (int n_threads : { 1, 2 }) {
+        auto decoder = make_ldpc_decoder(ldpc.get());
+        const int batch_size = 2 * decoder->simd_size() + 3;
+        ldpc_decoder_pool pool(ldpc.get(), n_threads, batch_size);
+        BOOST_CHECK_EQUAL(pool.batch_size(), batch_size);
+        std::vector<uint8_t> codewords;
+        std::vector<int8_t> llrs;
+        gen_noisy_batch(ldpc.get(), batch_size, 5.0, n_threads, codewords, llrs);
+
+        // Full and partial batches
+        for (int n_frames : { batch_size, 5 }) {
+            ldpc_batch_t* batch = pool.acquire();
+            BOOST_REQUIRE(batch != nullptr);
+            std::copy(llrs.begin(), llrs.begin() + n_frames * n, batch->llr.begin());
+            batch->frame_cnt = 0;
+            batch->n_frames = n_frames;
+            batch->trials = trials;
+            pool.submit(batch);
+            batch = pool.front(/*wait=*/true);
+            BOOST_REQUIRE(batch != nullptr);
+            BOOST_CHECK_GE(batch->result, 0);
+            BOOST_CHECK_EQUAL(
+                *std::min_element(batch->results.begin(),
+                                  batch->results.begin() + n_frames),
+                batch->result);
+            const int len = n_frames * n;
+            std::vector<int8_t> out(batch->llr.begin(), batch->llr.begin() + len);
+            std::vector<uint8_t> ref(codewords.begin(), codewords.begin() + len);
+            BOOST_CHECK_EQUAL(count_bit_errors(ref, out), 0);
+            pool.release();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_table_specialized)
+{
+    // The table-specialized decoder should produce the same results as the generic
+    // decoder, including on codes with irregular check node degrees
+    struct code_t {
+        dvb_framesize_t framesize;
+        dvb_code_rate_t rate;
+        float esn0_db;
+    };
+    const int trials = 25;
+    for (const auto& c : { code_t{ FECFRAME_SHORT, C1_2, 2.0 },
+                           code_t{ FECFRAME_SHORT, C8_9, 7.0 },
+                           code_t{ FECFRAME_NORMAL, C3_5, 3.0 },
+                           code_t{ FECFRAME_NORMAL, C9_10, 7.0 } }) {
+        auto ldpc = make_ldpc_code(STANDARD_DVBS2, c.framesize, c.rate);
+        auto generic = make_ldpc_decoder(ldpc.get());
+        auto specialized = make_ldpc_decoder(STANDARD_DVBS2, c.framesize, c.rate);
+        BOOST_REQUIRE(specialized != nullptr);
+        BOOST_REQUIRE_EQUAL(specialized->simd_size(), generic->simd_size());
+        std::vector<uint8_t> codewords;
+        std::vector<int8_t> llrs;
+        gen_noisy_batch(ldpc.get(), generic->simd_size(), c.esn0_db, 7, codewords, llrs);
+        std::vector<int8_t> out_generic = llrs;
+        std::vector<int8_t> out_specialized = llrs;
+        BOOST_CHECK_EQUAL(generic->decode(out_generic.data(), trials),
+                          specialized->decode(out_specialized.data(), trials));
+        BOOST_CHECK(out_generic == out_specialized);
+    }
+
+    BOOST_CHECK(make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_MEDIUM, C1_2) == nullptr);
+    BOOST_CHECK_THROW(ldpc_decoder_pool(STANDARD_DVBS2, FECFRAME_MEDIUM, C1_2, 1),
+                      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_backends)
+{
+    // The best backend comes first and the generic one last, and every backend
+    // decodes each codeword of a batch the same way
+    const std::vector<std::string> backends = get_ldpc_backends();
+    BOOST_REQUIRE(!backends.empty());
+    BOOST_CHECK_EQUAL(backends.back(), "generic");
+    auto best = make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    BOOST_CHECK_EQUAL(best->impl(), backends.front());
+
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_2);
+    const int n = ldpc->code_len();
+    std::vector<uint8_t> codewords;
+    std::vector<int8_t> llrs;
+    gen_noisy_batch(ldpc.get(), 1, 2.0, 11, codewords, llrs);
+    std::vector<int8_t> ref_out;
+    for (const auto& backend : backends) {
+        auto decoder = make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_SHORT, C1_2, backend);
+        BOOST_REQUIRE(decoder != nullptr);
+        BOOST_CHECK_EQUAL(decoder->impl(), backend);
+        std::vector<const int8_t*> frames(decoder->simd_size(), llrs.data());
+        std::vector<int8_t> out(decoder->simd_size() * n);
+        BOOST_CHECK(decoder->decode(frames.data(), 25) >= 0);
+        decoder->store(out.data());
+        out.resize(n); // first codeword only
+        if (ref_out.empty())
+            ref_out = out;
+        BOOST_CHECK(out == ref_out);
+    }
+
+    BOOST_CHECK(make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_SHORT, C1_2, "none") ==
+                nullptr);
+    BOOST_CHECK(make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_MEDIUM, C1_2, "generic") ==
+                nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_decoder_int16)
+{
+    // The 16-bit decoders of all backends produce the same output, and at an SNR
+    // where the 8-bit decoder fails on most frames of a VL-SNR code, they decode all
+    // frames, also when refilling the lanes one frame at a time
+    const int trials = 25;
+    BOOST_CHECK_EQUAL(ldpc_auto_precision(STANDARD_DVBS2, FECFRAME_SHORT, C1_5_VLSNR),
+                      LDPC_PRECISION_INT16);
+    BOOST_CHECK_EQUAL(ldpc_auto_precision(STANDARD_DVBS2, FECFRAME_NORMAL, C1_3),
+                      LDPC_PRECISION_INT16);
+    BOOST_CHECK_EQUAL(ldpc_auto_precision(STANDARD_DVBS2, FECFRAME_NORMAL, C2_5),
+                      LDPC_PRECISION_INT8);
+
+    auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_SHORT, C1_5_VLSNR);
+    const int n = ldpc->code_len();
+    auto decoder8 = make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_SHORT, C1_5_VLSNR);
+    auto decoder16 = make_ldpc_decoder(
+        STANDARD_DVBS2, FECFRAME_SHORT, C1_5_VLSNR, LDPC_PRECISION_AUTO);
+    BOOST_CHECK_EQUAL(decoder16->impl(), std::string(decoder8->impl()) + "_int16");
+    std::vector<std::unique_ptr<LDPCDecoderInterface>> decoders;
+    int n_frames = decoder16->simd_size(); // frames fitting the lanes of all backends
+    for (const auto& backend : get_ldpc_backends()) {
+        decoders.push_back(make_ldpc_decoder(
+            STANDARD_DVBS2, FECFRAME_SHORT, C1_5_VLSNR, backend + "_int16"));
+        BOOST_REQUIRE(decoders.back() != nullptr);
+        BOOST_CHECK_EQUAL(decoders.back()->impl(), backend + "_int16");
+        n_frames = std::min(n_frames, decoders.back()->simd_size());
+    }
+    std::vector<uint8_t> codewords;
+    std::vector<int8_t> llrs;
+    gen_noisy_batch(ldpc.get(), n_frames, -4.0, 5, codewords, llrs);
+    std::vector<const int8_t*> frames(decoder8->simd_size(), nullptr);
+    for (int i = 0; i < n_frames; i++)
+        frames[i] = llrs.data() + i * n;
+
+    std::vector<int> results(decoder8->simd_size());
+    decoder8->decode(frames.data(), results.data(), trials);
+    int failed8 = 0, iterations8 = 0;
+    for (int i = 0; i < n_frames; i++) {
+        failed8 += results[i] < 0;
+        iterations8 += results[i] < 0 ? trials : trials - results[i];
+    }
+
+    std::vector<int8_t> ref_out;
+    for (const auto& decoder : decoders) {
+        std::vector<const int8_t*> lanes(decoder->simd_size(), nullptr);
+        std::copy(frames.begin(), frames.begin() + n_frames, lanes.begin());
+        std::vector<int> lane_results(decoder->simd_size());
+        BOOST_CHECK_GE(decoder->decode(lanes.data(), lane_results.data(), trials), 0);
+        int iterations16 = 0;
+        for (int i = 0; i < n_frames; i++)
+            iterations16 += trials - lane_results[i];
+        BOOST_CHECK_LT(iterations16, iterations8);
+        std::vector<int8_t> out(decoder->simd_size() * n);
+        decoder->store(out.data());
+        out.resize(n_frames * n);
+        BOOST_CHECK_EQUAL(count_bit_errors(codewords, out), 0);
+        if (ref_out.empty())
+            ref_out = out;
+        BOOST_CHECK(out == ref_out);
+    }
+    BOOST_CHECK_GT(failed8, n_frames / 2);
+
+    std::vector<int8_t> out(n_frames * n);
+    std::vector<int> frame_results(n_frames);
+    decoder16->decode_rolling(
+        frames.data(), out.data(), n_frames, frame_results.data(), trials);
+    BOOST_CHECK_EQUAL(count_bit_errors(codewords, out), 0);
+    for (int i = 0; i < n_frames; i++)
+        BOOST_CHECK_GE(frame_results[i], 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_connectivity_cache)
+{
+    const auto stats0 = get_ldpc_cache_stats();
+    {
+        // Decoders of the same code share a single connectivity, also across threads
+        auto conn = get_ldpc_connectivity(STANDARD_DVBS2, FECFRAME_NORMAL, C2_3);
+        BOOST_REQUIRE(conn != nullptr);
+        BOOST_CHECK_EQUAL(conn->N, 64800);
+        BOOST_CHECK(get_ldpc_connectivity(STANDARD_DVBS2, FECFRAME_NORMAL, C2_3) == conn);
+        std::vector<std::unique_ptr<LDPCDecoderInterface>> decoders(4);
+        std::vector<std::thread> threads;
+        for (auto& decoder : decoders)
+            threads.emplace_back([&decoder] {
+                decoder = make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_NORMAL, C2_3);
+            });
+        for (auto& thread : threads)
+            thread.join();
+        ldpc_decoder_pool pool(STANDARD_DVBS2, FECFRAME_NORMAL, C2_3, 2);
+        const auto stats1 = get_ldpc_cache_stats();
+        BOOST_CHECK_EQUAL(stats1.misses - stats0.misses, 1u);
+        // second lookup, decoders, and pool (own lookup plus one per decoding thread)
+        BOOST_CHECK_EQUAL(stats1.hits - stats0.hits, 1 + decoders.size() + 3);
+        BOOST_CHECK_EQUAL(stats1.entries - stats0.entries, 1u);
+        BOOST_CHECK_EQUAL(stats1.bytes - stats0.bytes, conn->size());
+
+        // A decoder using the cached connectivity decodes like a standalone one
+        auto ldpc = make_ldpc_code(STANDARD_DVBS2, FECFRAME_NORMAL, C2_3);
+        auto standalone = make_ldpc_decoder(ldpc.get());
+        std::vector<uint8_t> codewords;
+        std::vector<int8_t> llrs;
+        gen_noisy_batch(ldpc.get(), standalone->simd_size(), 4.0, 3, codewords, llrs);
+        std::vector<int8_t> out_standalone = llrs;
+        std::vector<int8_t> out_cached = llrs;
+        BOOST_CHECK_EQUAL(standalone->decode(out_standalone.data(), 25),
+                          decoders[0]->decode(out_cached.data(), 25));
+        BOOST_CHECK(out_standalone == out_cached);
+        BOOST_CHECK_EQUAL(get_ldpc_cache_stats().misses, stats1.misses);
+    }
+
+    // The connectivity is released with its last decoder and prepared again afterwards
+    const auto stats2 = get_ldpc_cache_stats();
+    BOOST_CHECK_EQUAL(stats2.entries, stats0.entries);
+    BOOST_CHECK(make_ldpc_decoder(STANDARD_DVBS2, FECFRAME_NORMAL, C2_3) != nullptr);
+    BOOST_CHECK_EQUAL(get_ldpc_cache_stats().misses, stats2.misses + 1);
+
+    BOOST_CHECK(get_ldpc_connectivity(STANDARD_DVBS2, FECFRAME_MEDIUM, C1_2) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_pack_hard_decisions)
+{
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> llr_dist(-128, 127);
+    // Normal and short FECFRAME lengths, plus lengths leaving partial vectors
+    for (int len : { 64800, 16200, 3240, 8, 24, 120, 136 }) {
+        std::vector<int8_t> soft(len);
+        for (auto& llr : soft)
+            llr = llr_dist(rng);
+        soft[0] = 0; // zero maps to bit 0
+        soft[len - 1] = -1;
+        std::vector<uint8_t> expected(len / 8);
+        for (int j = 0; j < len / 8; j++)
+            for (int k = 0; k < 8; k++)
+                expected[j] |= (soft[j * 8 + k] < 0) << (7 - k);
+        // Sentinel after the last byte to catch overruns
+        std::vector<uint8_t> bytes(len / 8 + 1, 0xa5);
+        ldpc_pack_hard_decisions(bytes.data(), soft.data(), len);
+        BOOST_CHECK_EQUAL(bytes.back(), 0xa5);
+        bytes.pop_back();
+        BOOST_CHECK(bytes == expected);
+    }
+}
+
+} // namespace dvbs2rx
+} // namespace gr
@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 Igor Freire.
+ *
+ * This file is part of gr-dvbs2rx.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "ldpc_trials_budget.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace gr {
+namespace dvbs2rx {
+
+BOOST_AUTO_TEST_CASE(test_ldpc_trials_budget_snr_estimate)
+{
+    // Scaled antipodal symbols in Gaussian noise, with the decoded codeword given by
+    // the transmitted bits (packed with the MSB first)
+    const int len = 64800;
+    const float scale = 16;
+    std::mt19937 gen(3);
+    std::bernoulli_distribution bit_dist;
+    for (float snr_db : { 0.0f, 3.0f, 6.0f }) {
+        const float sigma = std::sqrt(std::pow(10.0f, -snr_db / 10));
+        std::normal_distribution<float> noise(0, sigma);
+        std::vector<int8_t> channel(len);
+        std::vector<uint8_t> decoded(len / 8);
+        for (int i = 0; i < len; i++) {
+            const float sym = bit_dist(gen) ? -1 : 1;
+            const float llr = std::round(scale * (sym + noise(gen)));
+            channel[i] = std::min(std::max(llr, -128.0f), 127.0f);
+            decoded[i / 8] |= (sym < 0) << (7 - i % 8);
+        }
+        const float estimate =
+            ldpc_trials_budget::estimate_snr(channel.data(), decoded.data(), len);
+        BOOST_CHECK_SMALL(estimate - snr_db, 0.2f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_ldpc_trials_budget_policy)
+{
+    const int max_trials = 25;
+    const int window = 64;
+    ldpc_trials_budget budget(max_trials, window);
+    BOOST_CHECK_EQUAL(budget.budget(), max_trials);
+    BOOST_CHECK(std::isnan(budget.snr()));
+
+    // Frames decoding reliably within 8 iterations: 99th percentile plus margin
+    for (int batch = 0; batch < 4; batch++) {
+        for (int i = 0; i < 16; i++)
+            budget.add_frame(i % 2 ? 6 : 8, true);
+        budget.add_snr(6.0);
+        budget.update();
+    }
+    BOOST_CHECK_EQUAL(budget.budget(), 8 + 2 + 8 / 4);
+    BOOST_CHECK_CLOSE(budget.snr(), 6.0, 1e-3);
+
+    // Frames failing at the same SNR get the maximum budget
+    budget.add_frame(0, false);
+    budget.add_snr(6.0);
+    BOOST_CHECK_EQUAL(budget.update(), max_trials);
+
+    // Most frames failing with a significant SNR drop (fade): minimum budget
+    for (int batch = 0; batch < 8; batch++) {
+        for (int i = 0; i < 16; i++)
+            budget.add_frame(0, false);
+        budget.add_snr(2.0);
+        budget.update();
+    }
+    BOOST_CHECK_EQUAL(budget.budget(), max_trials / 5);
+
+    // Back to the maximum budget as soon as the SNR recovers
+    for (int batch = 0; batch < 8 && budget.budget() < max_trials; batch++) {
+        for (int i = 0; i < 16; i++)
+            budget.add_frame(0, false);
+        budget.add_snr(6.0);
+        budget.update();
+    }
+    BOOST_CHECK_EQUAL(budget.budget(), max_trials);
+
+    // And back to the percentile once the failures leave the window
+    for (int batch = 0; batch < 4; batch++) {
+        for (int i = 0; i < 16; i++)
+            budget.add_frame(12, true);
+        budget.add_snr(6.0);
+        budget.update();
+    }
+    BOOST_CHECK_EQUAL(budget.budget(), 12 + 2 + 12 / 4);
+}
+
+} // namespace dvbs2rx
+} // namespace gr
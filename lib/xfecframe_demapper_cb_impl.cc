@@ -74,6 +74,7 @@ xfecframe_demapper_cb_impl::xfecframe_demapper_cb_impl(dvb_framesize_t framesize
     d_xfecframe_len = d_fecframe_len / d_mod->bits();
     d_aux_8i_buffer.resize(d_fecframe_len);
     d_aux_8i_buffer_2.resize(d_fecframe_len);
+    d_aux_8i_buffer_3.resize(d_fecframe_len);
 
     // Initialize the pool of XFECFRAME buffers used for post-decoder SNR estimation
     for (size_t i = 0; i < d_xfecframe_buffer_pool.size(); i++) {
@@ -205,6 +206,8 @@ void xfecframe_demapper_cb_impl::handle_llr_pdu(pmt::pmt_t pdu)
     }
     static const pmt::pmt_t simd_size_key = pmt::intern("simd_size");
     static const pmt::pmt_t frame_key = pmt::intern("frame_cnt");
+    static const pmt::pmt_t packed_key = pmt::intern("packed");
+    static const pmt::pmt_t frame_idx_key = pmt::intern("frame_idx");
     if (!pmt::dict_has_key(meta, simd_size_key)) {
         d_logger->error("PDU metadata has no simd_size key. Dropping...");
         return;
@@ -216,6 +219,13 @@ void xfecframe_demapper_cb_impl::handle_llr_pdu(pmt::pmt_t pdu)
     int simd_size = pmt::to_long(pmt::dict_ref(meta, simd_size_key, pmt::PMT_NIL));
     uint64_t starting_frame_cnt =
         pmt::to_uint64(pmt::dict_ref(meta, frame_key, pmt::PMT_NIL));
+    // Stream index of each frame, if given, as the frames decoded together are not
+    // necessarily consecutive (e.g., in ACM/VCM mode)
+    const pmt::pmt_t frame_idx = pmt::dict_ref(meta, frame_idx_key, pmt::PMT_NIL);
+    const bool has_frame_idx =
+        pmt::is_u64vector(frame_idx) && pmt::length(frame_idx) == (size_t)simd_size;
+    // Hard decisions packed into bytes (MSB first) instead of the int8 soft LLRs
+    bool packed = pmt::to_bool(pmt::dict_ref(meta, packed_key, pmt::PMT_F));
 
     // PDU data
     if (pmt::length(v_data) == 0) {
@@ -234,6 +244,8 @@ void xfecframe_demapper_cb_impl::handle_llr_pdu(pmt::pmt_t pdu)
     size_t n_llr = 0;
     const int8_t* p_pdu_data =
         static_cast<const int8_t*>(pmt::uniform_vector_elements(v_data, n_llr));
+    if (packed)
+        n_llr *= 8;
     if (n_llr != simd_size * d_fecframe_len) {
         d_logger->error(
             "PDU does not have the expected number of LLRs (n_llr = {:d}). Dropping...",
@@ -248,7 +260,8 @@ void xfecframe_demapper_cb_impl::handle_llr_pdu(pmt::pmt_t pdu)
         // Find the corresponding XFECFRAME buffer
         size_t buffer_idx;
         bool buffer_found = false;
-        uint64_t frame_num = starting_frame_cnt + i_frame;
+        uint64_t frame_num = has_frame_idx ? pmt::u64vector_ref(frame_idx, i_frame)
+                                           : starting_frame_cnt + i_frame;
         for (size_t i = 0; i < d_xfecframe_saved.size(); i++) {
             if (d_xfecframe_saved[i] == frame_num) {
                 buffer_idx = i;
@@ -267,6 +280,16 @@ void xfecframe_demapper_cb_impl::handle_llr_pdu(pmt::pmt_t pdu)
 
         // Refine the SNR estimate using the given LLR vector
         const int8_t* p_llr = p_pdu_data + (i_frame * d_fecframe_len);
+        if (packed) {
+            // Unpack the hard decisions into +-1 LLRs
+            const uint8_t* p_bytes = reinterpret_cast<const uint8_t*>(p_pdu_data) +
+                                     (i_frame * d_fecframe_len / 8);
+            int8_t* p_unpacked = d_aux_8i_buffer_3.data();
+            for (unsigned int j = 0; j < d_fecframe_len; j++) {
+                p_unpacked[j] = ((p_bytes[j / 8] >> (7 - (j % 8))) & 1) ? -1 : 1;
+            }
+            p_llr = p_unpacked;
+        }
         const gr_complex* p_xfecframe = d_xfecframe_buffer_pool[buffer_idx].data();
         if (d_constellation == MOD_QPSK) {
             snr_lin_accum += d_qpsk->estimate_snr(p_xfecframe, p_llr, d_xfecframe_len);
@@ -47,6 +47,7 @@ private:
     uint64_t d_frame_cnt; /**< Total count of processed frames */
     volk::vector<int8_t> d_aux_8i_buffer;
     volk::vector<int8_t> d_aux_8i_buffer_2;
+    volk::vector<int8_t> d_aux_8i_buffer_3;
     Modulation<gr_complex, int8_t>* d_mod;
     std::unique_ptr<QpskConstellation> d_qpsk;
     gr::thread::mutex d_mutex;
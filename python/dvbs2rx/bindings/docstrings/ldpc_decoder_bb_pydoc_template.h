@@ -25,3 +25,21 @@ static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_make = R"doc()doc";
 
 
 static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_get_average_trials = R"doc()doc";
+
+
+static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_get_trials_budget = R"doc()doc";
+
+
+static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_get_average_latency = R"doc()doc";
+
+
+static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_get_average_iterations = R"doc()doc";
+
+
+static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_get_iteration_histogram = R"doc()doc";
+
+
+static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_get_max_iteration_count = R"doc()doc";
+
+
+static const char* __doc_gr_dvbs2rx_ldpc_decoder_bb_get_average_decode_time = R"doc()doc";
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(dvb_config.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(6b4f50866cfad992a0afe38a39e0a0e4)                     */
+/* BINDTOOL_HEADER_FILE_HASH(0ec8603053c50b7555c1bfaed3f0a4be)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -132,4 +132,23 @@ void bind_dvb_config(py::module& m)
         .value("INFO_OFF", ::gr::dvbs2rx::INFO_OFF) // 0
         .value("INFO_ON", ::gr::dvbs2rx::INFO_ON)   // 1
         .export_values();
+    py::enum_<::gr::dvbs2rx::dvb_llr_feedback_t>(m, "dvb_llr_feedback_t")
+        .value("LLR_FEEDBACK_OFF", ::gr::dvbs2rx::LLR_FEEDBACK_OFF)   // 0
+        .value("LLR_FEEDBACK_SOFT", ::gr::dvbs2rx::LLR_FEEDBACK_SOFT) // 1
+        .value("LLR_FEEDBACK_HARD", ::gr::dvbs2rx::LLR_FEEDBACK_HARD) // 2
+        .export_values();
+    py::enum_<::gr::dvbs2rx::dvb_ldpc_schedule_t>(m, "dvb_ldpc_schedule_t")
+        .value("LDPC_SCHEDULE_LAYERED", ::gr::dvbs2rx::LDPC_SCHEDULE_LAYERED)   // 0
+        .value("LDPC_SCHEDULE_FLOODING", ::gr::dvbs2rx::LDPC_SCHEDULE_FLOODING) // 1
+        .export_values();
+    py::enum_<::gr::dvbs2rx::dvb_ldpc_precision_t>(m, "dvb_ldpc_precision_t")
+        .value("LDPC_PRECISION_INT8", ::gr::dvbs2rx::LDPC_PRECISION_INT8)   // 0
+        .value("LDPC_PRECISION_INT16", ::gr::dvbs2rx::LDPC_PRECISION_INT16) // 1
+        .value("LDPC_PRECISION_AUTO", ::gr::dvbs2rx::LDPC_PRECISION_AUTO)   // 2
+        .export_values();
+    py::enum_<::gr::dvbs2rx::dvb_bch_converged_t>(m, "dvb_bch_converged_t")
+        .value("BCH_CONVERGED_DECODE", ::gr::dvbs2rx::BCH_CONVERGED_DECODE) // 0
+        .value("BCH_CONVERGED_CHECK", ::gr::dvbs2rx::BCH_CONVERGED_CHECK)   // 1
+        .value("BCH_CONVERGED_SKIP", ::gr::dvbs2rx::BCH_CONVERGED_SKIP)     // 2
+        .export_values();
 }
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(ldpc_decoder_bb.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(6600d4874aba2dd3820976811b5e2cee)                     */
+/* BINDTOOL_HEADER_FILE_HASH(d512682638e3f11cff6701d162de0dc1)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -47,11 +47,51 @@ void bind_ldpc_decoder_bb(py::module& m)
              py::arg("infomode"),
              py::arg("max_trials"),
              py::arg("debug_level") = 0,
+             py::arg("num_threads") = 1,
+             py::arg("batch_frames") = 0,
+             py::arg("batch_timeout_ms") = 0,
+             py::arg("acm_vcm") = false,
+             py::arg("llr_feedback") = ::gr::dvbs2rx::LLR_FEEDBACK_SOFT,
+             py::arg("llr_feedback_interval") = 1,
+             py::arg("adaptive_trials") = false,
+             py::arg("schedule") = ::gr::dvbs2rx::LDPC_SCHEDULE_LAYERED,
+             py::arg("precision") = ::gr::dvbs2rx::LDPC_PRECISION_INT8,
+             py::arg("check_period") = 1,
              D(ldpc_decoder_bb, make))
 
         .def("get_average_trials",
              &ldpc_decoder_bb::get_average_trials,
              D(ldpc_decoder_bb, get_average_trials))
 
+
+        .def("get_trials_budget",
+             &ldpc_decoder_bb::get_trials_budget,
+             D(ldpc_decoder_bb, get_trials_budget))
+
+
+        .def("get_average_latency",
+             &ldpc_decoder_bb::get_average_latency,
+             D(ldpc_decoder_bb, get_average_latency))
+
+
+        .def("get_average_iterations",
+             &ldpc_decoder_bb::get_average_iterations,
+             D(ldpc_decoder_bb, get_average_iterations))
+
+
+        .def("get_iteration_histogram",
+             &ldpc_decoder_bb::get_iteration_histogram,
+             D(ldpc_decoder_bb, get_iteration_histogram))
+
+
+        .def("get_max_iteration_count",
+             &ldpc_decoder_bb::get_max_iteration_count,
+             D(ldpc_decoder_bb, get_max_iteration_count))
+
+
+        .def("get_average_decode_time",
+             &ldpc_decoder_bb::get_average_decode_time,
+             D(ldpc_decoder_bb, get_average_decode_time))
+
         ;
 }
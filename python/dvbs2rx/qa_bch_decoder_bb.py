@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2024 Igor Freire.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import pmt
+from gnuradio import blocks, gr, gr_unittest
+
+try:
+    from gnuradio.dvbs2rx import (BCH_CONVERGED_CHECK, BCH_CONVERGED_DECODE,
+                                  BCH_CONVERGED_SKIP, C1_2, FECFRAME_NORMAL,
+                                  OM_MESSAGE, STANDARD_DVBS2, bch_decoder_bb)
+except ImportError:
+    from python.dvbs2rx import (BCH_CONVERGED_CHECK, BCH_CONVERGED_DECODE,
+                                BCH_CONVERGED_SKIP, C1_2, FECFRAME_NORMAL,
+                                OM_MESSAGE, STANDARD_DVBS2, bch_decoder_bb)
+
+# BCH codeword and message lengths in bytes for the normal 1/2 code
+N_BYTES = 32400 // 8
+K_BYTES = 32208 // 8
+
+
+class qa_bch_decoder_bb(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def run_decoder(self, converged_mode, num_threads=1):
+        # All-zero codewords, the second and third with a single bit error. The
+        # first two frames are tagged as converged by the LDPC decoder, the third
+        # as not converged, and the fourth is untagged.
+        codewords = [0] * (4 * N_BYTES)
+        codewords[N_BYTES] = 0x80
+        codewords[2 * N_BYTES] = 0x80
+        tags = []
+        for i, (converged, iterations) in enumerate([(True, 3), (True, 5),
+                                                     (False, 25)]):
+            tag = gr.tag_t()
+            tag.offset = i * N_BYTES
+            tag.key = pmt.intern("ldpc_status")
+            tag.value = pmt.cons(pmt.from_bool(converged),
+                                 pmt.from_long(iterations))
+            tags.append(tag)
+
+        src = blocks.vector_source_b(codewords, False, 1, tags)
+        decoder = bch_decoder_bb(STANDARD_DVBS2,
+                                 FECFRAME_NORMAL,
+                                 C1_2,
+                                 OM_MESSAGE,
+                                 converged_mode=converged_mode,
+                                 num_threads=num_threads)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.tb.run()
+        self.assertEqual(len(snk.data()), 4 * K_BYTES)
+        self.assertEqual(decoder.get_frame_count(), 4)
+        return decoder, snk.data()
+
+    def test_instance(self):
+        instance = bch_decoder_bb(STANDARD_DVBS2, FECFRAME_NORMAL, C1_2,
+                                  OM_MESSAGE)
+        assert (instance is not None)
+        self.assertEqual(instance.get_frame_count(), 0)
+        self.assertEqual(instance.get_error_count(), 0)
+
+    def test_converged_decode(self):
+        # The status tags are ignored and every frame is decoded
+        decoder, data = self.run_decoder(BCH_CONVERGED_DECODE)
+        self.assertFalse(any(data))
+        self.assertEqual(decoder.get_error_count(), 0)
+
+    def test_converged_check(self):
+        # The bit error of the converged frame is detected but not corrected
+        decoder, data = self.run_decoder(BCH_CONVERGED_CHECK)
+        self.assertEqual(data[K_BYTES], 0x80)
+        self.assertFalse(any(data[:K_BYTES]) or any(data[K_BYTES + 1:]))
+        self.assertEqual(decoder.get_error_count(), 1)
+
+    def test_converged_skip(self):
+        # The converged frames are output as received and counted as error-free
+        decoder, data = self.run_decoder(BCH_CONVERGED_SKIP)
+        self.assertEqual(data[K_BYTES], 0x80)
+        self.assertFalse(any(data[:K_BYTES]) or any(data[K_BYTES + 1:]))
+        self.assertEqual(decoder.get_error_count(), 0)
+
+    def test_num_threads(self):
+        # Same as with a single thread, with the frames split across the threads
+        decoder, data = self.run_decoder(BCH_CONVERGED_DECODE, num_threads=3)
+        self.assertFalse(any(data))
+        self.assertEqual(decoder.get_error_count(), 0)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_bch_decoder_bb)
@@ -0,0 +1,402 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2024 Igor Freire.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import numpy as np
+import pmt
+from gnuradio import blocks, gr, gr_unittest
+
+try:
+    from gnuradio.dvbs2rx import (C1_2, C1_4, FECFRAME_NORMAL, FECFRAME_SHORT,
+                                  INFO_OFF, LDPC_PRECISION_AUTO,
+                                  LDPC_SCHEDULE_FLOODING, LLR_FEEDBACK_HARD,
+                                  MOD_QPSK, OM_MESSAGE, STANDARD_DVBS2,
+                                  ldpc_decoder_bb)
+except ImportError:
+    from python.dvbs2rx import (C1_2, C1_4, FECFRAME_NORMAL, FECFRAME_SHORT,
+                                INFO_OFF, LDPC_PRECISION_AUTO,
+                                LDPC_SCHEDULE_FLOODING, LLR_FEEDBACK_HARD,
+                                MOD_QPSK, OM_MESSAGE, STANDARD_DVBS2,
+                                ldpc_decoder_bb)
+
+# (MODCOD, short FECFRAME) -> (n_ldpc, k_ldpc)
+LDPC_DIMS = {
+    (4, False): (64800, 32400),  # QPSK 1/2, normal
+    (1, True): (16200, 3240),  # QPSK 1/4, short
+    (12, True): (16200, 9720),  # 8PSK 3/5, short
+}
+
+
+class qa_ldpc_decoder_bb(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = ldpc_decoder_bb(STANDARD_DVBS2, FECFRAME_NORMAL, C1_2,
+                                   MOD_QPSK, OM_MESSAGE, INFO_OFF, 25)
+        assert (instance is not None)
+        self.assertEqual(instance.get_trials_budget(), 25)
+
+    def test_acm_vcm(self):
+        # Frames of three MODCODs interleaved, each an all-zero codeword with a
+        # few unreliable bit errors for the decoder to correct
+        frames = [(4, False), (1, True), (4, False), (12, True), (1, True),
+                  (12, True)]
+        llrs = []
+        tags = []
+        expected_tags = []
+        n_out_bytes = 0
+        for i, (modcod, short_fecframe) in enumerate(frames):
+            n_ldpc, k_ldpc = LDPC_DIMS[(modcod, short_fecframe)]
+            frame = np.full(n_ldpc, 64, dtype=np.int8)
+            frame[i::1000] = -8
+            tag = gr.tag_t()
+            tag.offset = len(llrs)
+            tag.key = pmt.intern("XFECFRAME")
+            tag.value = pmt.cons(pmt.from_long(modcod),
+                                 pmt.from_bool(short_fecframe))
+            tags.append(tag)
+            expected_tags.append((n_out_bytes, modcod, short_fecframe))
+            llrs.extend(frame.view(np.uint8).tolist())
+            n_out_bytes += k_ldpc // 8
+
+        # With two frames per batch, the batches complete out of frame order
+        # (e.g., the first QPSK 1/4 frame completes its batch only after the
+        # QPSK 1/2 batch), while the output must still follow the input order.
+        src = blocks.vector_source_b(llrs, False, 1, tags)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  batch_frames=2,
+                                  acm_vcm=True)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), n_out_bytes)
+        self.assertFalse(any(snk.data()))
+        out_tags = [(t.offset, pmt.to_long(pmt.car(t.value)),
+                     pmt.to_bool(pmt.cdr(t.value))) for t in snk.tags()
+                    if pmt.symbol_to_string(t.key) == "XFECFRAME"]
+        self.assertEqual(out_tags, expected_tags)
+
+    def test_acm_vcm_invalid_modcod(self):
+        # A normal frame tagged with an out-of-range MODCOD between two QPSK 1/2
+        # frames. MODCOD 257 would alias MODCOD 1 (QPSK 1/4) if narrowed to
+        # eight bits, so it must be discarded rather than decoded.
+        n_ldpc, k_ldpc = LDPC_DIMS[(4, False)]
+        llrs = []
+        tags = []
+        for modcod in [4, 257, 4]:
+            tag = gr.tag_t()
+            tag.offset = len(llrs)
+            tag.key = pmt.intern("XFECFRAME")
+            tag.value = pmt.cons(pmt.from_long(modcod), pmt.from_bool(False))
+            tags.append(tag)
+            llrs.extend([64] * n_ldpc)
+
+        src = blocks.vector_source_b(llrs, False, 1, tags)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  acm_vcm=True)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), 2 * k_ldpc // 8)
+        out_tags = [(t.offset, pmt.to_long(pmt.car(t.value)))
+                    for t in snk.tags()
+                    if pmt.symbol_to_string(t.key) == "XFECFRAME"]
+        self.assertEqual(out_tags, [(0, 4), (k_ldpc // 8, 4)])
+
+    def test_llr_feedback(self):
+        # Single-frame batches of all-zero codewords, with a few unreliable bit
+        # errors, and the hard decisions of every other batch fed back
+        n_frames = 5
+        n_ldpc, k_ldpc = LDPC_DIMS[(4, False)]
+        llrs = []
+        for i in range(n_frames):
+            frame = np.full(n_ldpc, 64, dtype=np.int8)
+            frame[i::1000] = -8
+            llrs.extend(frame.view(np.uint8).tolist())
+
+        src = blocks.vector_source_b(llrs, False)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  batch_frames=1,
+                                  llr_feedback=LLR_FEEDBACK_HARD,
+                                  llr_feedback_interval=2)
+        snk = blocks.vector_sink_b()
+        dbg = blocks.message_debug()
+        self.tb.connect(src, decoder, snk)
+        self.tb.msg_connect((decoder, 'llr_pdu'), (dbg, 'store'))
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), n_frames * k_ldpc // 8)
+        self.assertEqual(dbg.num_messages(), 3)  # batches 0, 2, and 4
+        for i in range(dbg.num_messages()):
+            pdu = dbg.get_message(i)
+            meta = pmt.car(pdu)
+            self.assertTrue(
+                pmt.to_bool(pmt.dict_ref(meta, pmt.intern("packed"),
+                                         pmt.PMT_F)))
+            self.assertEqual(
+                pmt.to_uint64(
+                    pmt.dict_ref(meta, pmt.intern("frame_cnt"), pmt.PMT_NIL)),
+                2 * i)
+            data = pmt.u8vector_elements(pmt.cdr(pdu))
+            self.assertEqual(len(data), n_ldpc // 8)
+            self.assertFalse(any(data))
+
+    def test_llr_feedback_acm_vcm(self):
+        # Frames of two MODCODs interleaved, so that the frames decoded
+        # together in each batch are not consecutive in the stream
+        frames = [(4, False), (1, True), (4, False), (1, True)]
+        llrs = []
+        tags = []
+        for i, (modcod, short_fecframe) in enumerate(frames):
+            n_ldpc, _ = LDPC_DIMS[(modcod, short_fecframe)]
+            frame = np.full(n_ldpc, 64, dtype=np.int8)
+            frame[i::1000] = -8
+            tag = gr.tag_t()
+            tag.offset = len(llrs)
+            tag.key = pmt.intern("XFECFRAME")
+            tag.value = pmt.cons(pmt.from_long(modcod),
+                                 pmt.from_bool(short_fecframe))
+            tags.append(tag)
+            llrs.extend(frame.view(np.uint8).tolist())
+
+        src = blocks.vector_source_b(llrs, False, 1, tags)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  batch_frames=2,
+                                  acm_vcm=True,
+                                  llr_feedback=LLR_FEEDBACK_HARD,
+                                  llr_feedback_interval=1)
+        snk = blocks.vector_sink_b()
+        dbg = blocks.message_debug()
+        self.tb.connect(src, decoder, snk)
+        self.tb.msg_connect((decoder, 'llr_pdu'), (dbg, 'store'))
+        self.tb.run()
+
+        # The batches are retired in the order of their first frames
+        expected = [((4, False), [0, 2]), ((1, True), [1, 3])]
+        self.assertEqual(dbg.num_messages(), len(expected))
+        for i, (key, frame_idx) in enumerate(expected):
+            pdu = dbg.get_message(i)
+            meta = pmt.car(pdu)
+            self.assertEqual(
+                pmt.to_long(
+                    pmt.dict_ref(meta, pmt.intern("simd_size"), pmt.PMT_NIL)),
+                len(frame_idx))
+            self.assertEqual(
+                pmt.to_uint64(
+                    pmt.dict_ref(meta, pmt.intern("frame_cnt"), pmt.PMT_NIL)),
+                frame_idx[0])
+            self.assertEqual(
+                list(
+                    pmt.u64vector_elements(
+                        pmt.dict_ref(meta, pmt.intern("frame_idx"),
+                                     pmt.PMT_NIL))), frame_idx)
+            data = pmt.u8vector_elements(pmt.cdr(pdu))
+            n_ldpc, _ = LDPC_DIMS[key]
+            self.assertEqual(len(data), len(frame_idx) * n_ldpc // 8)
+            self.assertFalse(any(data))
+
+    def test_adaptive_trials(self):
+        # Single-frame batches of all-zero codewords with a few unreliable bit
+        # errors, which converge well within the maximum number of iterations
+        n_frames = 8
+        n_ldpc, k_ldpc = LDPC_DIMS[(4, False)]
+        llrs = []
+        for i in range(n_frames):
+            frame = np.full(n_ldpc, 64, dtype=np.int8)
+            frame[i::1000] = -8
+            llrs.extend(frame.view(np.uint8).tolist())
+
+        src = blocks.vector_source_b(llrs, False)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  batch_frames=1,
+                                  adaptive_trials=True)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.assertEqual(decoder.get_trials_budget(), 25)
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), n_frames * k_ldpc // 8)
+        self.assertFalse(any(snk.data()))
+        self.assertLess(decoder.get_trials_budget(), 25)
+
+    def test_flooding_schedule(self):
+        # Frames decoded one at a time, each split across two threads
+        n_frames = 4
+        n_ldpc, k_ldpc = LDPC_DIMS[(4, False)]
+        llrs = []
+        for i in range(n_frames):
+            frame = np.full(n_ldpc, 64, dtype=np.int8)
+            frame[i::1000] = -8
+            llrs.extend(frame.view(np.uint8).tolist())
+
+        src = blocks.vector_source_b(llrs, False)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  num_threads=2,
+                                  schedule=LDPC_SCHEDULE_FLOODING)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), n_frames * k_ldpc // 8)
+        self.assertFalse(any(snk.data()))
+        self.assertGreater(decoder.get_average_latency(), 0)
+
+    def test_iteration_stats(self):
+        # Three error-free frames, which converge without any iteration, decoded
+        # in the same batch as a frame of random LLRs, which never converges
+        n_ldpc, k_ldpc = LDPC_DIMS[(4, False)]
+        rng = np.random.default_rng(0)
+        llrs = []
+        for i in range(3):
+            llrs.extend(np.full(n_ldpc, 64, dtype=np.int8).view(np.uint8))
+        noise = rng.integers(-16, 16, n_ldpc, dtype=np.int8)
+        llrs.extend(noise.view(np.uint8))
+
+        src = blocks.vector_source_b([int(x) for x in llrs], False)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  batch_frames=4)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), 4 * k_ldpc // 8)
+        hist = decoder.get_iteration_histogram()
+        self.assertEqual(len(hist), 26)
+        self.assertEqual(hist[0], 3)
+        self.assertEqual(hist[25], 1)
+        self.assertEqual(sum(hist), 4)
+        self.assertEqual(decoder.get_max_iteration_count(), 1)
+        self.assertAlmostEqual(decoder.get_average_iterations(), 25 / 4)
+        self.assertGreater(decoder.get_average_decode_time(), 0)
+
+        # Each output frame is tagged with its convergence status and iterations
+        status_tags = [(t.offset, pmt.to_bool(pmt.car(t.value)),
+                        pmt.to_long(pmt.cdr(t.value))) for t in snk.tags()
+                       if pmt.symbol_to_string(t.key) == "ldpc_status"]
+        self.assertEqual(status_tags, [(i * k_ldpc // 8, i < 3, 0 if i < 3 else 25)
+                                       for i in range(4)])
+
+    def test_check_period(self):
+        # All-zero codewords with a few unreliable bit errors, decoded with the
+        # convergence checked only on every fourth iteration
+        n_frames = 3
+        n_ldpc, k_ldpc = LDPC_DIMS[(4, False)]
+        llrs = []
+        for i in range(n_frames):
+            frame = np.full(n_ldpc, 64, dtype=np.int8)
+            frame[i::1000] = -8
+            llrs.extend(frame.view(np.uint8).tolist())
+
+        src = blocks.vector_source_b(llrs, False)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_NORMAL,
+                                  C1_2,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  batch_frames=1,
+                                  check_period=4)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), n_frames * k_ldpc // 8)
+        self.assertFalse(any(snk.data()))
+        self.assertEqual(decoder.get_max_iteration_count(), 0)
+
+        with self.assertRaises(ValueError):
+            ldpc_decoder_bb(STANDARD_DVBS2,
+                            FECFRAME_NORMAL,
+                            C1_2,
+                            MOD_QPSK,
+                            OM_MESSAGE,
+                            INFO_OFF,
+                            25,
+                            check_period=0)
+
+    def test_precision(self):
+        # Rate 1/4 frames, decoded with 16-bit precision in automatic mode,
+        # each an all-zero codeword with low-magnitude LLRs and a few bit errors
+        n_frames = 4
+        n_ldpc, k_ldpc = LDPC_DIMS[(1, True)]
+        llrs = []
+        for i in range(n_frames):
+            frame = np.full(n_ldpc, 2, dtype=np.int8)
+            frame[i::100] = -1
+            llrs.extend(frame.view(np.uint8).tolist())
+
+        src = blocks.vector_source_b(llrs, False)
+        decoder = ldpc_decoder_bb(STANDARD_DVBS2,
+                                  FECFRAME_SHORT,
+                                  C1_4,
+                                  MOD_QPSK,
+                                  OM_MESSAGE,
+                                  INFO_OFF,
+                                  25,
+                                  batch_frames=1,
+                                  precision=LDPC_PRECISION_AUTO)
+        snk = blocks.vector_sink_b()
+        self.tb.connect(src, decoder, snk)
+        self.tb.run()
+
+        self.assertEqual(len(snk.data()), n_frames * k_ldpc // 8)
+        self.assertFalse(any(snk.data()))
+        self.assertEqual(decoder.get_max_iteration_count(), 0)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_ldpc_decoder_bb)